@@ -31,15 +31,19 @@
 	#include <QRecursiveMutex>
 #endif
 
+#include <QSemaphore>
 #include <QThread>
 #include <QVector>
 #include <QWaitCondition>
 #include <samplerate.h>
 
+#include <atomic>
+#include <functional>
+#include <vector>
 
 #include "lmms_basics.h"
 #include "LocklessList.h"
-#include "FifoBuffer.h"
+#include "LocklessQueue.h"
 #include "AudioEngineProfiler.h"
 #include "PlayHandle.h"
 
@@ -188,6 +192,22 @@ public:
 			}
 			return SRC_LINEAR;
 		}
+
+		//! How many frames filters modulated by envelopes or LFOs glide
+		//! towards their next coefficients instead of recalculating them,
+		//! see InstrumentSoundShaping. The best setting keeps calculating
+		//! them for every frame.
+		fpp_t filterControlInterval() const
+		{
+			switch( interpolation )
+			{
+				case Interpolation_Linear: return 32;
+				case Interpolation_SincFastest: return 16;
+				case Interpolation_SincMedium: return 8;
+				case Interpolation_SincBest: return 1;
+			}
+			return 1;
+		}
 	} ;
 
 	void initDevices();
@@ -223,15 +243,14 @@ public:
 
 
 	// audio-port-stuff
-	inline void addAudioPort(AudioPort * port)
+	void addAudioPort(AudioPort * port);
+	void removeAudioPort(AudioPort * port);
+
+	const QVector<AudioPort *> & audioPorts() const
 	{
-		requestChangeInModel();
-		m_audioPorts.push_back(port);
-		doneChangeInModel();
+		return m_audioPorts;
 	}
 
-	void removeAudioPort(AudioPort * port);
-
 
 	// MIDI-client-stuff
 	inline const QString & midiClientName() const
@@ -359,6 +378,18 @@ public:
 		return RequestChangesGuard{this};
 	}
 
+	//! Let the audio thread apply change right before it renders the next
+	//! period. Unlike requestChangeInModel(), neither the calling thread nor
+	//! the audio thread waits for the other one. change is destroyed later
+	//! outside of the audio thread, so it may own whatever it replaced.
+	void postChangeInModel( std::function<void()> change );
+	//! Wait until all posted changes have been applied, e.g. before deleting
+	//! something they removed. Only the calling thread waits. Doesn't wait
+	//! at all if the engine isn't processing or the calling thread is
+	//! within requestChangeInModel(), as the changes are applied right away
+	//! then.
+	void waitForPostedChanges();
+
 	static bool isAudioDevNameValid(QString name);
 	static bool isMidiDevNameValid(QString name);
 
@@ -370,7 +401,38 @@ signals:
 
 
 private:
-	using Fifo = FifoBuffer<surroundSampleFrame*>;
+	//! Passes the rendered periods from the fifoWriter to the audio device
+	//! without allocating or copying them. A fixed set of buffers circulates
+	//! between a queue of free and a queue of rendered ones; the semaphores
+	//! only put a thread to sleep when it has to wait for the other one.
+	class Fifo
+	{
+	public:
+		Fifo( int size, fpp_t frames );
+		~Fifo();
+
+		//! A buffer to render into, waits if all of them are in use
+		surroundSampleFrame * acquire();
+		//! Give back a buffer which won't be written
+		void release( surroundSampleFrame * buffer );
+
+		//! Pass a rendered buffer to the reader, nullptr ends reading
+		void write( surroundSampleFrame * buffer );
+		//! The next rendered buffer. It stays valid until read() is called
+		//! again, which releases it.
+		surroundSampleFrame * read();
+
+		//! Wait until the reader has released everything written
+		void waitUntilRead();
+
+	private:
+		std::vector<surroundSampleFrame *> m_buffers;
+		LocklessQueue<surroundSampleFrame *> m_free;
+		LocklessQueue<surroundSampleFrame *> m_written;
+		QSemaphore m_freeCount;
+		QSemaphore m_writtenCount;
+		surroundSampleFrame * m_reading;
+	} ;
 
 	class fifoWriter : public QThread
 	{
@@ -379,11 +441,15 @@ private:
 
 		void finish();
 
+		//! The buffer to render the next period into
+		surroundSampleFrame * takeNextBuffer();
+
 
 	private:
 		AudioEngine * m_audioEngine;
 		Fifo * m_fifo;
 		volatile bool m_writing;
+		surroundSampleFrame * m_nextBuffer;
 
 		void run() override;
 
@@ -480,6 +546,24 @@ private:
 
 	bool m_waitingForWrite;
 
+	struct PostedChange
+	{
+		std::function<void()> apply;
+		PostedChange * next;
+	} ;
+
+	void applyPostedChanges();
+	//! Apply the posted changes on the calling thread
+	void applyPostedChangesNow();
+	void reclaimPostedChanges();
+
+	// pushed by any thread, taken by whoever applies them
+	std::atomic<PostedChange *> m_postedChanges;
+	// applied changes, deleted by the threads posting new ones
+	std::atomic<PostedChange *> m_appliedChanges;
+	std::atomic<unsigned> m_postedCount;
+	std::atomic<unsigned> m_appliedCount;
+
 	friend class Engine;
 	friend class AudioEngineWorkerThread;
 	friend class ProjectRenderer;
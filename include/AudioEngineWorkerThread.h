@@ -25,11 +25,12 @@
 #ifndef AUDIO_ENGINE_WORKER_THREAD_H
 #define AUDIO_ENGINE_WORKER_THREAD_H
 
+#include <QMutex>
 #include <QThread>
+#include <QWaitCondition>
 
 #include <atomic>
-
-class QWaitCondition;
+#include <cstdint>
 
 namespace lmms
 {
@@ -42,6 +43,12 @@ class AudioEngineWorkerThread : public QThread
 	Q_OBJECT
 public:
 	// internal representation of the job queue - all functions are thread-safe
+	//
+	// Every participating thread owns a work-stealing deque. Jobs are pushed
+	// onto the deque of the thread adding them, so jobs which get queued by
+	// other jobs (e.g. mixer channels whose senders just finished) stay on
+	// the core that produced their input. Idle threads steal from the other
+	// deques and park after a bounded amount of spinning.
 	class JobQueue
 	{
 	public:
@@ -51,16 +58,40 @@ public:
 			Dynamic	// jobs can be added while processing queue
 		} ;
 
+		// capacity of a single thread's deque, must be a power of two
 		static constexpr size_t JOB_QUEUE_SIZE = 8192;
-
-		JobQueue() :
-			m_items(),
-			m_writeIndex( 0 ),
-			m_itemsDone( 0 ),
-			m_opMode( Static )
+		// maximum number of threads (including the audio thread) taking
+		// part in job processing
+		static constexpr int MAX_THREADS = 256;
+		// number of unsuccessful attempts to find work before parking
+		static constexpr int MAX_IDLE_SPINS = 2048;
+
+		// Chase-Lev deque with a fixed-size ring: the owning thread pushes
+		// and pops at the bottom, all other threads steal from the top
+		class Deque
 		{
-			std::fill(m_items, m_items + JOB_QUEUE_SIZE, nullptr);
-		}
+		public:
+			Deque();
+
+			//! Owner only. Returns false if the deque is full.
+			bool push( ThreadableJob * _job );
+			//! Owner only. Returns the most recently pushed job.
+			ThreadableJob * pop();
+			//! Any thread. Returns the oldest job or nullptr if the deque
+			//! is empty or another thread won the race for it.
+			ThreadableJob * steal();
+
+		private:
+			static constexpr std::int64_t MASK = JOB_QUEUE_SIZE - 1;
+			static_assert( ( JOB_QUEUE_SIZE & MASK ) == 0,
+				"JOB_QUEUE_SIZE must be a power of two" );
+
+			alignas(64) std::atomic<std::int64_t> m_top;
+			alignas(64) std::atomic<std::int64_t> m_bottom;
+			std::atomic<ThreadableJob*> m_items[JOB_QUEUE_SIZE];
+		} ;
+
+		JobQueue();
 
 		void reset( OperationMode _opMode );
 
@@ -68,12 +99,40 @@ public:
 
 		void run();
 		void wait();
+		//! Wait for a queued job, processing other jobs in the meantime.
+		//! Can be called from within a job.
+		void waitFor( ThreadableJob * _job );
+
+		//! Make the calling thread take part in job processing using the
+		//! given deque. Returns false if there are too many threads.
+		bool registerThread( Deque * _deque );
+		void unregisterThread();
+		//! Make the calling thread the owner of the main deque while it
+		//! renders a period. Other threads which aren't registered only
+		//! steal jobs and process the jobs they add right away.
+		void setRenderingThread( bool _rendering );
 
 	private:
-		std::atomic<ThreadableJob*> m_items[JOB_QUEUE_SIZE];
-		std::atomic_int m_writeIndex;
+		void processJobs( bool _untilDone );
+		ThreadableJob * findJob();
+		void jobDone();
+		void park( int _seenPushes );
+		void wakeParkedThreads();
+
+		// slot 0 belongs to the deque of the thread rendering the current
+		// period, the workers register themselves in the free slots after it
+		Deque m_mainDeque;
+		std::atomic<Deque*> m_deques[MAX_THREADS];
+		std::atomic_int m_numDeques;
+
+		std::atomic_int m_itemsQueued;
 		std::atomic_int m_itemsDone;
+		std::atomic_int m_pushCount;
 		OperationMode m_opMode;
+
+		std::atomic_int m_parkedThreads;
+		QMutex m_parkMutex;
+		QWaitCondition m_parkCond;
 	} ;
 
 
@@ -93,6 +152,16 @@ public:
 		globalJobQueue.addJob( _job );
 	}
 
+	static void waitForJob( ThreadableJob * _job )
+	{
+		globalJobQueue.waitFor( _job );
+	}
+
+	static void setRenderingThread( bool _rendering )
+	{
+		globalJobQueue.setRenderingThread( _rendering );
+	}
+
 	// a convenient helper function allowing to pass a container with pointers
 	// to ThreadableJob objects
 	template<typename T>
@@ -116,6 +185,7 @@ private:
 	static QWaitCondition * queueReadyWaitCond;
 	static QList<AudioEngineWorkerThread *> workerThreads;
 
+	JobQueue::Deque m_deque;
 	volatile bool m_quit;
 } ;
 
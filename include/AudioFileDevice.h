@@ -27,8 +27,12 @@
 #define AUDIO_FILE_DEVICE_H
 
 #include <QFile>
+#include <QSemaphore>
+#include <memory>
+#include <vector>
 
 #include "AudioDevice.h"
+#include "LocklessQueue.h"
 #include "OutputSettings.h"
 
 namespace lmms
@@ -49,6 +53,15 @@ public:
 
 	OutputSettings const & getOutputSettings() const { return m_outputSettings; }
 
+	// Encoding in a thread of its own: after startEncoder(), call
+	// queueNextBuffer() instead of processNextBuffer(). The rendered periods
+	// are collected into larger blocks, which writeBuffer() is called with
+	// from the encoder thread. finishEncoder() waits until everything has
+	// been written and has to be called before the device is destroyed.
+	void startEncoder();
+	void queueNextBuffer();
+	void finishEncoder();
+
 
 protected:
 	int writeData( const void* data, int len );
@@ -64,8 +77,31 @@ protected:
 	}
 
 private:
+	class EncoderThread;
+
+	struct Block
+	{
+		std::vector<surroundSampleFrame> frames;
+		fpp_t used;
+		float masterGain;
+	} ;
+
+	void pushBlock();
+	void encodeBlocks();
+
 	QFile m_outputFile;
 	OutputSettings m_outputSettings;
+
+	// the pool of blocks cycles through these two queues, the semaphores
+	// count their entries so each side can sleep while it has to wait
+	std::vector<Block> m_blocks;
+	LocklessQueue<Block *> m_freeBlocks;
+	LocklessQueue<Block *> m_filledBlocks;
+	QSemaphore m_freeCount;
+	QSemaphore m_filledCount;
+	Block * m_currentBlock;
+
+	std::unique_ptr<EncoderThread> m_encoder;
 } ;
 
 using AudioFileDeviceInstantiaton
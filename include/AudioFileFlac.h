@@ -65,6 +65,10 @@ private:
 	SF_INFO  m_sfinfo;
 	SNDFILE* m_sf;
 
+	// reused for the conversion of every block
+	std::vector<sample_t> m_floatBuffer;
+	std::vector<int_sample_t> m_intBuffer;
+
 	void writeBuffer(surroundSampleFrame const* _ab,
 						fpp_t const frames,
 						float master_gain) override;
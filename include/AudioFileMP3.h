@@ -69,6 +69,10 @@ private:
 
 private:
 	lame_t m_lame;
+
+	// reused for every block
+	std::vector<float> m_interleavedBuffer;
+	std::vector<unsigned char> m_encodingBuffer;
 };
 
 } // namespace lmms
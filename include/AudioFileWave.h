@@ -66,6 +66,10 @@ private:
 private:
 	SF_INFO m_si;
 	SNDFILE * m_sf;
+
+	// reused for the conversion of every block
+	std::vector<float> m_floatBuffer;
+	std::vector<int_sample_t> m_intBuffer;
 } ;
 
 
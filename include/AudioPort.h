@@ -25,10 +25,12 @@
 #ifndef AUDIO_PORT_H
 #define AUDIO_PORT_H
 
+#include <atomic>
 #include <memory>
 #include <QString>
 #include <QMutex>
 
+#include "CompensationDelay.h"
 #include "MemoryManager.h"
 #include "PlayHandle.h"
 
@@ -85,9 +87,20 @@ public:
 		return m_effects.get();
 	}
 
-	void setNextMixerChannel( const mix_ch_t _chnl )
+	void setNextMixerChannel( const mix_ch_t _chnl );
+
+
+	// latency of whatever renders into this port, e.g. an instrument
+	void setSourceLatency( f_cnt_t frames );
+
+	// total latency of the signal leaving this port, including effects
+	f_cnt_t latency() const;
+
+	// delay applied to the port's output to line it up with the other
+	// inputs of its mixer channel - set by the mixer
+	void setCompensationDelay( f_cnt_t frames )
 	{
-		m_nextMixerChannel = _chnl;
+		m_compensationDelay.setDelay( frames );
 	}
 
 
@@ -112,6 +125,8 @@ public:
 	void removePlayHandle( PlayHandle * handle );
 
 private:
+	void requestLatencyUpdate();
+
 	volatile bool m_bufferUsage;
 
 	sampleFrame * m_portBuffer;
@@ -119,6 +134,12 @@ private:
 
 	bool m_extOutputEnabled;
 	mix_ch_t m_nextMixerChannel;
+	// position in the audio engine's list of ports, used for summing the
+	// ports feeding a mixer channel in a deterministic order
+	int m_mixOrder;
+
+	std::atomic<f_cnt_t> m_sourceLatency;
+	CompensationDelay m_compensationDelay;
 
 	QString m_name;
 
@@ -27,7 +27,9 @@
 
 #include <QMap>
 #include <QMutex>
+#include <array>
 
+#include "AutomationCurve.h"
 #include "JournallingObject.h"
 #include "Model.h"
 #include "TimePos.h"
@@ -215,6 +217,15 @@ public:
 	void setAutomatedValue( const float value );
 	void setValue( const float value );
 
+	//! Let valueBuffer() follow curve from frame offset of the current
+	//! period on, instead of ramping between the values given to
+	//! setAutomatedValue(). tick is the curve's tick at that frame, and the
+	//! curve holds its value after endTick. Without a curve, the value stays
+	//! as it is from offset on. A call which just continues the curve
+	//! changes nothing, so the song can repeat it at every tick.
+	void setAutomationCurve( const AutomationCurve * curve, float tick, float endTick,
+				f_cnt_t offset, float ticksPerFrame );
+
 	void incValue( int steps )
 	{
 		setValue( m_value + steps * m_step );
@@ -412,6 +423,22 @@ private:
 
 	bool m_hasSampleExactData;
 
+	// the automation curves followed in period m_automationPeriod, each
+	// from its offset on, see setAutomationCurve()
+	struct AutomationSpan
+	{
+		const AutomationCurve * curve;
+		f_cnt_t offset;
+		float tick;
+		float endTick;
+	} ;
+	static constexpr int MaxAutomationSpans = 8;
+	std::array<AutomationSpan, MaxAutomationSpans> m_automationSpans;
+	int m_automationSpanCount;
+	long m_automationPeriod;
+	float m_automationTicksPerFrame;
+	int m_automationCursor;
+
 	// prevent several threads from attempting to write the same vb at the same time
 	QMutex m_valueBufferMutex;
 
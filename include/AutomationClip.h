@@ -29,10 +29,12 @@
 
 #include <QMap>
 #include <QPointer>
+#include <memory>
 #if (QT_VERSION >= QT_VERSION_CHECK(5,14,0))
 	#include <QRecursiveMutex>
 #endif
 
+#include "AutomationCurve.h"
 #include "AutomationNode.h"
 #include "Clip.h"
 
@@ -68,7 +70,7 @@ public:
 
 	AutomationClip( AutomationTrack * _auto_track );
 	AutomationClip( const AutomationClip & _clip_to_copy );
-	~AutomationClip() override = default;
+	~AutomationClip() override;
 
 	bool addObject( AutomatableModel * _obj, bool _search_dup = true );
 
@@ -154,6 +156,24 @@ public:
 	float valueAt( const TimePos & _time ) const;
 	float *valuesAfter( const TimePos & _time ) const;
 
+	//! The nodes compiled for playback. The returned curve stays valid and
+	//! unchanged even if the clip is edited meanwhile.
+	std::shared_ptr<const AutomationCurve> curve() const
+	{
+		QMutexLocker m(&m_clipMutex);
+		return m_curve;
+	}
+
+	//! curve() for the audio thread, which doesn't lock the clip. Edits reach
+	//! it as posted changes, so the curve stays valid for the whole period.
+	const AutomationCurve & playbackCurve() const
+	{
+		return *m_playbackCurve;
+	}
+
+	//! valueAt() from the compiled curve, which takes fractions of ticks
+	float curveValueAt( float ticks ) const;
+
 	const QString name() const;
 
 	// settings-management
@@ -189,6 +209,8 @@ private:
 	void generateTangents();
 	void generateTangents(timeMap::iterator it, int numToGenerate);
 	float valueAt( timeMap::const_iterator v, int offset ) const;
+	std::shared_ptr<const AutomationCurve> compileCurve() const;
+	void updateCurve();
 
 	// Mutex to make methods involving automation clips thread safe
 	// Mutable so we can lock it from const objects
@@ -203,6 +225,9 @@ private:
 	objectVector m_objects;
 	timeMap m_timeMap;	// actual values
 	timeMap m_oldTimeMap;	// old values for storing the values before setDragValue() is called.
+	std::shared_ptr<const AutomationCurve> m_curve;	// m_timeMap for playback, replaced on every change
+	const AutomationCurve * m_playbackCurve;	// m_curve as seen by the audio thread
+	mutable int m_curveCursor;
 	float m_tension;
 	bool m_hasAutomation;
 	ProgressionTypes m_progressionType;
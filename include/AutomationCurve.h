@@ -0,0 +1,91 @@
+/*
+ * AutomationCurve.h - the nodes of an AutomationClip, compiled for playback
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef AUTOMATION_CURVE_H
+#define AUTOMATION_CURVE_H
+
+#include <vector>
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+//! Immutable table with one polynomial per pair of neighbouring nodes, so
+//! the value at any (fractional) tick costs a few multiplications instead
+//! of a map lookup. AutomationClip builds a new one after every edit; a
+//! curve which has been handed out never changes.
+class LMMS_EXPORT AutomationCurve
+{
+public:
+	struct Segment
+	{
+		//! ticks of this node and the next one
+		int start;
+		int end;
+		//! the value exactly at start
+		float inValue;
+		//! value at start + offset is a0 + t * (a1 + t * (a2 + t * a3))
+		//! with t = offset / (end - start)
+		float a0, a1, a2, a3;
+		float invLength;
+	} ;
+
+	//! Curve without any nodes, evaluates to 0
+	AutomationCurve();
+
+	//! segments have to be sorted and adjacent, lastInValue and lastOutValue
+	//! are the values of the node at lastPosition, where the curve ends
+	AutomationCurve( std::vector<Segment> segments, int lastPosition,
+				float lastInValue, float lastOutValue );
+
+	bool isEmpty() const
+	{
+		return m_empty;
+	}
+
+	//! Same as AutomationClip::valueAt(), but takes fractions of ticks.
+	//! cursor is the index of the segment the last call ended in; reading
+	//! the curve in order with the same cursor needs no search.
+	float valueAt( float tick, int & cursor ) const;
+
+	//! Values at tick, tick + step, tick + 2 * step, ..., holding the value
+	//! at endTick for ticks after it
+	void valuesAt( float tick, float step, float endTick,
+				float * values, int count, int & cursor ) const;
+
+private:
+	int findSegment( float tick, int cursor ) const;
+
+	std::vector<Segment> m_segments;
+	int m_lastPosition;
+	float m_lastInValue;
+	float m_lastOutValue;
+	bool m_empty;
+} ;
+
+
+} // namespace lmms
+
+#endif
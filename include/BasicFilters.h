@@ -37,6 +37,7 @@
 #endif
 
 #include <cmath>
+#include <type_traits>
 
 #include "lmms_basics.h"
 #include "lmms_constants.h"
@@ -289,7 +290,10 @@ public:
 		m_doubleFilter( false ),
 		m_sampleRate( (float) _sample_rate ),
 		m_sampleRatio( 1.0f / m_sampleRate ),
-		m_subFilter( nullptr )
+		m_subFilter( nullptr ),
+		m_coeffsType( -1 ),
+		m_glideSteps( 0 ),
+		m_glideCount( 0 )
 	{
 		clearHistory();
 	}
@@ -332,8 +336,120 @@ public:
 
 	inline sample_t update( sample_t _in0, ch_cnt_t _chnl )
 	{
-		sample_t out;
+		return withFilterType( [&]( auto type ) {
+			return this->template updateAs<decltype( type )::value>( _in0, _chnl );
+		} );
+	}
+
+	//! Filters frames frames of buf in place, the same as calling update()
+	//! for every sample, but the filter type is only looked at once.
+	//! beforeFrame( frame ) is called before every frame and may change
+	//! the coefficients.
+	template<typename F>
+	inline void process( sampleFrame * buf, const fpp_t frames, F && beforeFrame )
+	{
+		withFilterType( [&]( auto type ) {
+			for( fpp_t frame = 0; frame < frames; ++frame )
+			{
+				beforeFrame( frame );
+				for( ch_cnt_t chnl = 0; chnl < CHANNELS; ++chnl )
+				{
+					buf[frame][chnl] = this->template updateAs<decltype( type )::value>(
+										buf[frame][chnl], chnl );
+				}
+			}
+		} );
+	}
+
+
+	//! Moves the coefficients linearly towards the ones calcFilterCoeffs()
+	//! would set, reaching them after steps calls of stepFilterCoeffs().
+	//! Interpolating keeps the filters stable, e.g. the coefficients of stable
+	//! biquads form a triangle in (a1, a2). Jumps there right away if the
+	//! coefficients were calculated for another filter type before.
+	inline void glideFilterCoeffs( float _freq, float _q, int steps )
+	{
+		m_glideSteps = 0;
+		if( m_coeffsType != coeffsType() || steps <= 1 )
+		{
+			calcFilterCoeffs( _freq, _q );
+			return;
+		}
+
+		m_glideCount = activeCoeffs( m_glideCoeffs );
+		float start[MaxCoeffs];
+		for( int i = 0; i < m_glideCount; ++i )
+		{
+			start[i] = *m_glideCoeffs[i];
+		}
+
+		calcFilterCoeffs( _freq, _q );
+
+		for( int i = 0; i < m_glideCount; ++i )
+		{
+			m_glideTargets[i] = *m_glideCoeffs[i];
+			m_glideDeltas[i] = ( m_glideTargets[i] - start[i] ) / steps;
+			*m_glideCoeffs[i] = start[i];
+		}
+		m_glideSteps = steps;
+	}
+
+	//! To be called before filtering each frame after glideFilterCoeffs()
+	inline void stepFilterCoeffs()
+	{
+		if( m_glideSteps == 0 )
+		{
+			return;
+		}
+
+		if( --m_glideSteps == 0 )
+		{
+			for( int i = 0; i < m_glideCount; ++i )
+			{
+				*m_glideCoeffs[i] = m_glideTargets[i];
+			}
+			return;
+		}
+
+		for( int i = 0; i < m_glideCount; ++i )
+		{
+			*m_glideCoeffs[i] += m_glideDeltas[i];
+		}
+	}
+
+
+private:
+	//! Calls f with the filter type as std::integral_constant, so the
+	//! filter code can be specialized for it
+	template<typename F>
+	inline auto withFilterType( F && f )
+	{
 		switch( m_type )
+		{
+			case Moog: return f( std::integral_constant<FilterTypes, Moog>() );
+			case Tripole: return f( std::integral_constant<FilterTypes, Tripole>() );
+			case Lowpass_SV: return f( std::integral_constant<FilterTypes, Lowpass_SV>() );
+			case Bandpass_SV: return f( std::integral_constant<FilterTypes, Bandpass_SV>() );
+			case Highpass_SV: return f( std::integral_constant<FilterTypes, Highpass_SV>() );
+			case Notch_SV: return f( std::integral_constant<FilterTypes, Notch_SV>() );
+			case Lowpass_RC12: return f( std::integral_constant<FilterTypes, Lowpass_RC12>() );
+			case Highpass_RC12: return f( std::integral_constant<FilterTypes, Highpass_RC12>() );
+			case Bandpass_RC12: return f( std::integral_constant<FilterTypes, Bandpass_RC12>() );
+			case Lowpass_RC24: return f( std::integral_constant<FilterTypes, Lowpass_RC24>() );
+			case Highpass_RC24: return f( std::integral_constant<FilterTypes, Highpass_RC24>() );
+			case Bandpass_RC24: return f( std::integral_constant<FilterTypes, Bandpass_RC24>() );
+			case Formantfilter: return f( std::integral_constant<FilterTypes, Formantfilter>() );
+			case FastFormant: return f( std::integral_constant<FilterTypes, FastFormant>() );
+			// all of the others are biquads
+			default: return f( std::integral_constant<FilterTypes, LowPass>() );
+		}
+	}
+
+	template<FilterTypes TYPE>
+	inline sample_t updateAs( sample_t _in0, ch_cnt_t _chnl )
+	{
+		sample_t out;
+		switch( TYPE )
 		{
 			case Moog:
 			{
@@ -422,7 +538,7 @@ public:
 				}
 
 				/* mix filter output into output buffer */
-				return m_type == Lowpass_SV 
+				return TYPE == Lowpass_SV 
 					? m_delay4[_chnl]
 					: m_delay3[_chnl];
 			}
@@ -509,7 +625,7 @@ public:
 					m_rchp0[_chnl] = hp;
 					m_rcbp0[_chnl] = bp;
 				}
-				return m_type == Highpass_RC12 ? hp : bp;
+				return TYPE == Highpass_RC12 ? hp : bp;
 			}
 
 			case Lowpass_RC24:
@@ -576,7 +692,7 @@ public:
 					m_rcbp0[_chnl] = bp;
 
 					// second stage gets the output of the first stage as input...
-					in = m_type == Highpass_RC24
+					in = TYPE == Highpass_RC24
 						? hp + m_rcbp1[_chnl] * m_rcq
 						: bp + m_rcbp1[_chnl] * m_rcq;
 
@@ -592,7 +708,7 @@ public:
 					m_rchp1[_chnl] = hp;
 					m_rcbp1[_chnl] = bp;
 				}
-				return m_type == Highpass_RC24 ? hp : bp;
+				return TYPE == Highpass_RC24 ? hp : bp;
 			}
 
 			case Formantfilter:
@@ -602,7 +718,7 @@ public:
 				sample_t hp, bp, in;
 
 				out = 0;
-				const int os = m_type == FastFormant ? 1 : 4; // no oversampling for fast formant
+				const int os = TYPE == FastFormant ? 1 : 4; // no oversampling for fast formant
 				for( int o = 0; o < os; ++o )
 				{
 					// first formant
@@ -689,7 +805,7 @@ public:
 
 					out += bp;
 				}
-            	return m_type == FastFormant ? out * 2.0f : out * 0.5f;
+            	return TYPE == FastFormant ? out * 2.0f : out * 0.5f;
 			}
 
 			default:
@@ -699,7 +815,7 @@ public:
 
 		if( m_doubleFilter )
 		{
-			return m_subFilter->update( out, _chnl );
+			return m_subFilter->template updateAs<TYPE>( out, _chnl );
 		}
 
 		// Clipper band limited sigmoid
@@ -707,8 +823,11 @@ public:
 	}
 
 
+public:
 	inline void calcFilterCoeffs( float _freq, float _q )
 	{
+		m_coeffsType = coeffsType();
+
 		// temp coef vars
 		_q = qMax( _q, minQ() );
 
@@ -874,6 +993,81 @@ public:
 
 
 private:
+	static constexpr int MaxCoeffs = 10;
+
+	//! Identifies the set of coefficients calcFilterCoeffs() calculates
+	inline int coeffsType() const
+	{
+		return m_doubleFilter ? m_type + NumFilters : m_type;
+	}
+
+	//! Collects the coefficients update() uses with the current filter type
+	//! and returns how many there are
+	inline int activeCoeffs( float * * coeffs )
+	{
+		int count = 0;
+		switch( m_type )
+		{
+			case Lowpass_RC12:
+			case Bandpass_RC12:
+			case Highpass_RC12:
+			case Lowpass_RC24:
+			case Bandpass_RC24:
+			case Highpass_RC24:
+				coeffs[count++] = &m_rca;
+				coeffs[count++] = &m_rcb;
+				coeffs[count++] = &m_rcc;
+				coeffs[count++] = &m_rcq;
+				break;
+			case Formantfilter:
+			case FastFormant:
+				for( int i = 0; i < 2; ++i )
+				{
+					coeffs[count++] = &m_vfa[i];
+					coeffs[count++] = &m_vfb[i];
+					coeffs[count++] = &m_vfc[i];
+				}
+				coeffs[count++] = &m_vfq;
+				break;
+			case Moog:
+			case Tripole:
+				coeffs[count++] = &m_r;
+				coeffs[count++] = &m_p;
+				coeffs[count++] = &m_k;
+				if( m_doubleFilter )
+				{
+					coeffs[count++] = &m_subFilter->m_r;
+					coeffs[count++] = &m_subFilter->m_p;
+					coeffs[count++] = &m_subFilter->m_k;
+				}
+				break;
+			case Lowpass_SV:
+			case Bandpass_SV:
+			case Highpass_SV:
+			case Notch_SV:
+				coeffs[count++] = &m_svf1;
+				coeffs[count++] = &m_svf2;
+				coeffs[count++] = &m_svq;
+				break;
+			default:
+				coeffs[count++] = &m_biQuad.m_a1;
+				coeffs[count++] = &m_biQuad.m_a2;
+				coeffs[count++] = &m_biQuad.m_b0;
+				coeffs[count++] = &m_biQuad.m_b1;
+				coeffs[count++] = &m_biQuad.m_b2;
+				if( m_doubleFilter )
+				{
+					coeffs[count++] = &m_subFilter->m_biQuad.m_a1;
+					coeffs[count++] = &m_subFilter->m_biQuad.m_a2;
+					coeffs[count++] = &m_subFilter->m_biQuad.m_b0;
+					coeffs[count++] = &m_subFilter->m_biQuad.m_b1;
+					coeffs[count++] = &m_subFilter->m_biQuad.m_b2;
+				}
+				break;
+		}
+		return count;
+	}
+
 	// biquad filter
 	BiQuad<CHANNELS> m_biQuad;
 
@@ -913,6 +1107,14 @@ private:
 	float m_sampleRatio;
 	BasicFilters<CHANNELS> * m_subFilter;
 
+	// coefficients are only interpolated within the same type
+	int m_coeffsType;
+	int m_glideSteps;
+	int m_glideCount;
+	float * m_glideCoeffs[MaxCoeffs];
+	float m_glideTargets[MaxCoeffs];
+	float m_glideDeltas[MaxCoeffs];
+
 } ;
 
 
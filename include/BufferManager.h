@@ -47,6 +47,13 @@ public:
 #endif
 	static void release( sampleFrame * buf );
 
+	// Buffers which are only valid until the end of the current period.
+	// They come from an arena of the calling thread, so they don't need to be
+	// released and the ones used in one period lie next to each other.
+	static sampleFrame * acquireForPeriod();
+	//! Called by the audio engine when nothing uses these buffers anymore
+	static void finishPeriod();
+
 private:
 	static fpp_t s_framesPerPeriod;
 };
@@ -0,0 +1,83 @@
+/*
+ * ClipIndex.h - finds the clips of a track within a time range
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef CLIP_INDEX_H
+#define CLIP_INDEX_H
+
+#include <QVector>
+
+#include <vector>
+
+#include "lmms_basics.h"
+
+namespace lmms
+{
+
+class Clip;
+
+
+//! Interval tree over the clips of a track, so playback doesn't have to look
+//! at every clip of a long arrangement in every tick. The clips are kept
+//! sorted by their start and each one stores the latest end within its
+//! subtree of the implicit binary tree over that array.
+//!
+//! The index doesn't notice when clips move, so the track builds a new one
+//! after changes and swaps it in while the audio thread waits.
+class ClipIndex
+{
+public:
+	ClipIndex() = default;
+	//! Allocates, so it's not for the audio thread
+	explicit ClipIndex( const QVector<Clip *> & clips );
+
+	void swap( ClipIndex & other )
+	{
+		m_entries.swap( other.m_entries );
+	}
+
+	//! Insert all clips overlapping [start, end] into result, which is kept
+	//! sorted by start position
+	void clipsInRange( QVector<Clip *> & result, tick_t start, tick_t end ) const;
+
+private:
+	struct Entry
+	{
+		Clip * clip;
+		tick_t start;
+		tick_t end;
+		//! latest end within the subtree rooted here
+		tick_t maxEnd;
+	} ;
+
+	tick_t build( int begin, int end );
+	void query( int begin, int end, tick_t start, tick_t stop,
+						QVector<Clip *> & result ) const;
+
+	std::vector<Entry> m_entries;
+} ;
+
+
+} // namespace lmms
+
+#endif
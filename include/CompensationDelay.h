@@ -0,0 +1,71 @@
+/*
+ * CompensationDelay.h - delay line for plugin delay compensation
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef COMPENSATION_DELAY_H
+#define COMPENSATION_DELAY_H
+
+#include <memory>
+
+#include "lmms_basics.h"
+
+namespace lmms
+{
+
+//! Integer delay line which shifts a signal by a whole number of frames, used
+//! to line up signal paths with different plugin latencies.
+class CompensationDelay
+{
+public:
+	CompensationDelay();
+
+	f_cnt_t delay() const
+	{
+		return m_delay;
+	}
+
+	//! Change the delay, clearing the delayed audio. Not realtime safe
+	//! when the delay grows beyond what has been allocated before.
+	void setDelay( f_cnt_t frames );
+
+	//! Whether audio fed in earlier has not been fully written out yet
+	bool hasTail() const
+	{
+		return m_tail > 0;
+	}
+
+	//! Delay @p buf in place. @p active tells whether @p buf carries audio
+	//! (otherwise it is expected to be silent) and is used to track the tail.
+	void process( sampleFrame * buf, fpp_t frames, bool active );
+
+private:
+	std::unique_ptr<sampleFrame[]> m_buffer;
+	f_cnt_t m_capacity;
+	f_cnt_t m_delay;
+	f_cnt_t m_position;
+	f_cnt_t m_tail;
+} ;
+
+} // namespace lmms
+
+#endif
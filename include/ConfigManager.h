@@ -238,6 +238,10 @@ public:
 	// Returns true if the working dir (e.g. ~/lmms) exists on disk.
 	bool hasWorkingDir() const;
 
+	//! Directory for files which can be regenerated any time, like the
+	//! wavetables or what was found out about the installed plugins
+	QString cacheDir() const;
+
 	void addRecentlyOpenedProject(const QString & _file);
 
 	const QString & value(const QString & cls,
@@ -65,12 +65,21 @@ public:
 	bool processAudioBuffer( sampleFrame * _buf, const fpp_t _frames, bool hasInputNoise );
 	void startRunning();
 
+	//! Sum of the latencies of all enabled effects
+	f_cnt_t latency() const;
+
 	void clear();
 
 
 private:
 	using EffectList = QVector<Effect*>;
+
+	//! Hand a copy of m_effects over to the audio thread
+	void publishEffects();
+
 	EffectList m_effects;
+	//! The effects the audio thread processes, only touched by it
+	EffectList m_processedEffects;
 
 	BoolModel m_enabledModel;
 
@@ -78,6 +87,10 @@ private:
 	friend class gui::EffectRackView;
 
 
+private slots:
+	void invalidateLatency();
+
+
 signals:
 	void aboutToClear();
 
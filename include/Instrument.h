@@ -142,6 +142,9 @@ protected:
 	// desiredReleaseFrames() frames are left
 	void applyRelease( sampleFrame * buf, const NotePlayHandle * _n );
 
+	// the track's audio port has to be compensated for our latency
+	void latencyChanged() override;
+
 
 private:
 	InstrumentTrack * m_instrumentTrack;
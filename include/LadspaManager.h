@@ -30,7 +30,12 @@
 
 #include <ladspa.h>
 
+#include <atomic>
+
+#include <QByteArray>
+#include <QFileInfo>
 #include <QMap>
+#include <QMutex>
 #include <QPair>
 #include <QString>
 #include <QStringList>
@@ -51,9 +56,11 @@ using l_sortable_plugin_t = QList<sortable_plugin_t>;
 using l_ladspa_key_t = QList<ladspa_key_t>;
 
 /* LadspaManager provides a database of LADSPA plug-ins.  Upon instantiation,
-it loads all of the plug-ins found in the LADSPA_PATH environmental variable
+it finds all of the plug-ins in the LADSPA_PATH environmental variable
 and stores their access descriptors according in a dictionary keyed on
 the filename the plug-in was loaded from and the label of the plug-in.
+Libraries which are unchanged since the last run are only loaded once one
+of their plug-ins is actually used, see PluginDescriptorCache.
 
 The can be retrieved by using ladspa_key_t.  For example, to get the
 "Phase Modulated Voice" plug-in from the cmt library, you would perform the
@@ -75,11 +82,17 @@ enum LadspaPluginType
 
 struct LadspaManagerDescription
 {
-	LADSPA_Descriptor_Function descriptorFunction;
+	//! Stays null until the library is needed, as long as everything else
+	//! could be taken from the plugin cache
+	std::atomic<LADSPA_Descriptor_Function> descriptorFunction;
+	//! Absolute path of the library
+	QString file;
 	uint32_t index;
 	LadspaPluginType type;
 	uint16_t inputChannels;
 	uint16_t outputChannels;
+	QString name;
+	LADSPA_Properties properties;
 };
 
 class LMMS_EXPORT LadspaManager
@@ -331,8 +344,11 @@ public:
 						LADSPA_Handle _instance );
 
 private:
-	void  addPlugins( LADSPA_Descriptor_Function _descriptor_func,
-						const QString & _file );
+	//! What the plugin cache stores about the library
+	QByteArray  describePlugins( LADSPA_Descriptor_Function _descriptor_func );
+	void  addPlugins( const QByteArray & _plugins, const QFileInfo & _file,
+				LADSPA_Descriptor_Function _descriptor_func );
+	LADSPA_Descriptor_Function  loadLibrary( LadspaManagerDescription * _plugin );
 	uint16_t  getPluginInputs( const LADSPA_Descriptor * _descriptor );
 	uint16_t  getPluginOutputs( const LADSPA_Descriptor * _descriptor );
 
@@ -344,6 +360,7 @@ private:
 	using LadspaManagerMapType = QMap<ladspa_key_t, LadspaManagerDescription*>;
 	LadspaManagerMapType m_ladspaManagerMap;
 	l_sortable_plugin_t m_sortedPlugins;
+	QMutex m_loadMutex;
 
 } ;
 
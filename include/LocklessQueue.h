@@ -0,0 +1,103 @@
+/*
+ * LocklessQueue.h - bounded single producer, single consumer queue
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LOCKLESS_QUEUE_H
+#define LOCKLESS_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace lmms
+{
+
+//! Fixed size FIFO which may be pushed to by one thread and popped from by
+//! another one without locking. Neither side ever blocks: push() fails if
+//! the queue is full and pop() fails if it is empty.
+template<typename T>
+class LocklessQueue
+{
+public:
+	LocklessQueue( std::size_t capacity ) :
+		m_slots( capacity + 1 ),
+		m_head( 0 ),
+		m_tail( 0 )
+	{
+	}
+
+	std::size_t capacity() const
+	{
+		return m_slots.size() - 1;
+	}
+
+	//! Only to be called by the producer
+	bool push( const T & value )
+	{
+		const std::size_t tail = m_tail.load( std::memory_order_relaxed );
+		const std::size_t next = increment( tail );
+		if( next == m_head.load( std::memory_order_acquire ) )
+		{
+			return false;
+		}
+		m_slots[tail] = value;
+		m_tail.store( next, std::memory_order_release );
+		return true;
+	}
+
+	//! Only to be called by the consumer
+	bool pop( T & value )
+	{
+		const std::size_t head = m_head.load( std::memory_order_relaxed );
+		if( head == m_tail.load( std::memory_order_acquire ) )
+		{
+			return false;
+		}
+		value = m_slots[head];
+		m_head.store( increment( head ), std::memory_order_release );
+		return true;
+	}
+
+	//! Only reliable when called by the consumer
+	bool empty() const
+	{
+		return m_head.load( std::memory_order_acquire ) ==
+				m_tail.load( std::memory_order_acquire );
+	}
+
+private:
+	std::size_t increment( std::size_t index ) const
+	{
+		return index + 1 == m_slots.size() ? 0 : index + 1;
+	}
+
+	std::vector<T> m_slots;
+	// keep the indices written by different threads on different cache lines
+	alignas(64) std::atomic<std::size_t> m_head;
+	alignas(64) std::atomic<std::size_t> m_tail;
+} ;
+
+
+} // namespace lmms
+
+#endif
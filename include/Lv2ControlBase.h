@@ -138,6 +138,8 @@ protected:
 	std::size_t controlCount() const;
 	QString nodeName() const { return "lv2controls"; }
 	bool hasNoteInput() const;
+	//! Largest latency reported by any of the processors
+	f_cnt_t reportedLatency() const;
 	void handleMidiInputEvent(const class MidiEvent &event,
 		const class TimePos &time, f_cnt_t offset);
 
@@ -151,6 +153,11 @@ private:
 	//! If this is a mono effect, the vector will have size 2 in order to
 	//! fulfill LMMS' requirement of having stereo input and output
 	std::vector<std::unique_ptr<Lv2Proc>> m_procs;
+	//! Runs one of m_procs as a job of the worker threads
+	class RunJob;
+	//! One job for each processor except the first, which runs in the
+	//! calling thread
+	std::vector<std::unique_ptr<RunJob>> m_runJobs;
 
 	bool m_valid = true;
 	bool m_hasGUI = false;
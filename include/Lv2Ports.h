@@ -60,7 +60,7 @@ enum class Type {
 	Control,
 	Audio,
 	AtomSeq,
-	Cv //!< TODO: unused, describe
+	Cv //!< control values at audio rate, one per frame
 };
 
 //! Port visualization
@@ -175,6 +175,10 @@ struct Cv : public VisitablePort<Cv, ControlPortBase>
 	//! Model values are being copied here every run
 	//! Between runs, this data is not up-to-date
 	std::vector<float> m_buffer;
+	//! Input only: value at the end of the last run
+	float m_lastVal = 0.0f;
+	//! Input only: whether the whole buffer is m_lastVal
+	bool m_constant = false;
 };
 
 struct Audio : public VisitablePort<Audio, PortBase>
@@ -29,12 +29,15 @@
 
 #ifdef LMMS_HAVE_LV2
 
+#include <atomic>
 #include <lilv/lilv.h>
 #include <memory>
+#include <vector>
 
 #include "Lv2Basics.h"
 #include "Lv2Features.h"
 #include "Lv2Options.h"
+#include "Lv2Worker.h"
 #include "LinkedModelGroups.h"
 #include "Plugin.h"
 #include "../src/3rdparty/ringbuffer/include/ringbuffer/ringbuffer.h"
@@ -156,6 +159,8 @@ public:
 	class AutomatableModel *modelAtPort(const QString &uri); // unused currently
 	std::size_t controlCount() const { return LinkedModelGroup::modelNum(); }
 	bool hasNoteInput() const;
+	//! Latency in frames as last reported by the plugin, 0 if it reports none
+	f_cnt_t latency() const;
 
 protected:
 	/*
@@ -173,12 +178,22 @@ private:
 	LilvInstance* m_instance;
 	Lv2Features m_features;
 	Lv2Options m_options;
+	//! only if the plugin uses the worker extension
+	std::unique_ptr<Lv2Worker> m_worker;
 
 	// full list of ports
 	std::vector<std::unique_ptr<Lv2Ports::PortBase>> m_ports;
 	// quick reference to specific, unique ports
 	StereoPortRef m_inPorts, m_outPorts;
 	Lv2Ports::AtomSeq *m_midiIn = nullptr, *m_midiOut = nullptr;
+	//! control output with lv2:reportsLatency, if any
+	Lv2Ports::Control* m_latencyPort = nullptr;
+	//! control inputs, updated only if m_controlsChanged is set
+	std::vector<Lv2Ports::Control*> m_controlInputs;
+	//! all other inputs, which must be refreshed in each period
+	std::vector<Lv2Ports::PortBase*> m_otherInputs;
+	//! set by the connected models (or models linked to them) on any change
+	std::atomic<bool> m_controlsChanged{true};
 
 	// MIDI
 	// many things here may be moved into the `Instrument` class
@@ -0,0 +1,117 @@
+/*
+ * Lv2Worker.h - Lv2Worker class
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LV2WORKER_H
+#define LV2WORKER_H
+
+#include "lmmsconfig.h"
+
+#ifdef LMMS_HAVE_LV2
+
+#include <atomic>
+#include <vector>
+#include <lv2/lv2plug.in/ns/ext/worker/worker.h>
+
+#include "../src/3rdparty/ringbuffer/include/ringbuffer/ringbuffer.h"
+
+
+namespace lmms
+{
+
+
+/**
+	Host side of the Lv2 worker extension for one plugin instance
+
+	Work the plugin schedules in run() is passed through a lock-free
+	ringbuffer to a pool of non-realtime threads shared by all plugins. The
+	responses come back through another ringbuffer and are passed to the
+	plugin at the start of its next run(). While rendering, the work is done
+	right away in run(), so the result does not depend on timing.
+*/
+class Lv2Worker
+{
+public:
+	Lv2Worker();
+	//! Waits for work in progress, must be called before the instance is freed
+	~Lv2Worker();
+
+	//! Must be called once the plugin is instantiated
+	void setInstance(LV2_Handle handle, const LV2_Worker_Interface* iface);
+	//! Feature data for LV2_WORKER__schedule
+	LV2_Worker_Schedule* feature() { return &m_schedule; }
+
+	/*
+		utils for the run thread
+	*/
+	//! Pass the responses to the plugin, must be called before run()
+	void emitResponses();
+	//! Must be called after run()
+	void notifyEndOfRun();
+
+private:
+	static LV2_Worker_Status staticScheduleWork(
+		LV2_Worker_Schedule_Handle handle, uint32_t size, const void* data);
+	static LV2_Worker_Status staticRespond(
+		LV2_Worker_Respond_Handle handle, uint32_t size, const void* data);
+
+	LV2_Worker_Status scheduleWork(uint32_t size, const void* data);
+	//! Called by the worker pool, handles all pending requests
+	void work();
+
+	//! Write a message of the given size, or nothing if it does not fit
+	static bool writeMessage(ringbuffer_t<char>& ring, std::vector<char>& scratch,
+		uint32_t size, const void* data);
+	//! Read the next message into buf, return its size
+	static uint32_t readMessage(ringbuffer_reader_t<char>& reader,
+		std::vector<char>& buf);
+
+	LV2_Handle m_handle = nullptr;
+	const LV2_Worker_Interface* m_iface = nullptr;
+	LV2_Worker_Schedule m_schedule;
+
+	//! run() -> worker pool
+	ringbuffer_t<char> m_requests;
+	ringbuffer_reader_t<char> m_requestReader;
+	//! worker pool -> run()
+	ringbuffer_t<char> m_responses;
+	ringbuffer_reader_t<char> m_responseReader;
+	//! preallocated, so messages can be read and written without allocating
+	std::vector<char> m_requestBuf, m_responseBuf;
+	std::vector<char> m_requestScratch, m_responseScratch;
+
+	//! true while queued in or handled by the worker pool
+	std::atomic<bool> m_scheduled;
+	//! true while a thread of the worker pool uses this worker
+	std::atomic<bool> m_busy;
+	Lv2Worker* m_next = nullptr;
+
+	friend class Lv2WorkerPool;
+};
+
+
+} // namespace lmms
+
+#endif // LMMS_HAVE_LV2
+
+#endif // LV2WORKER_H
@@ -76,6 +76,10 @@ public:
 		return m_notes;
 	}
 
+	//! Index of the first note at or after pos. Only for playback, which
+	//! has to hold the track's lock.
+	int firstNoteFrom( const TimePos & pos ) const;
+
 	Note * addStepNote( int step );
 	void setStep( int step, bool enabled );
 
@@ -143,6 +147,9 @@ private:
 	NoteVector m_notes;
 	int m_steps;
 
+	// where firstNoteFrom() found the last note
+	mutable int m_playCursor;
+
 	MidiClip * adjacentMidiClipByOffset(int offset) const;
 
 	friend class gui::MidiClipView;
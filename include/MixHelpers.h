@@ -34,6 +34,29 @@ class ValueBuffer;
 namespace MixHelpers
 {
 
+/*! \brief Instruction sets the functions below can be run with. The best one
+ *  supported by the CPU is picked on first use. */
+enum class Isa
+{
+	Scalar,
+	Sse2,
+	Avx2,
+	Avx512
+} ;
+
+/*! \brief Whether both the build and the CPU support isa */
+bool isaSupported( Isa isa );
+
+/*! \brief The instruction set currently used */
+Isa isa();
+
+/*! \brief Switch to another instruction set, e.g. for benchmarking. Not
+ *  thread-safe. Returns false if isa is not supported. */
+bool setIsa( Isa isa );
+
+const char* isaName( Isa isa );
+
+
 bool isSilent( const sampleFrame* src, int frames );
 
 bool useNaNHandler();
@@ -42,6 +65,9 @@ void setNaNHandler( bool use );
 
 bool sanitize( sampleFrame * src, int frames );
 
+/*! \brief Raise left/right to the absolute peak of the respective channel of src */
+void peak( const sampleFrame* src, int frames, float& left, float& right );
+
 /*! \brief Add samples from src to dst */
 void add( sampleFrame* dst, const sampleFrame* src, int frames );
 
@@ -76,6 +102,18 @@ void multiplyAndAddMultiplied( sampleFrame* dst, const sampleFrame* src, float c
 /*! \brief Multiply dst by coeffDst and add samples from srcLeft/srcRight multiplied by coeffSrc */
 void multiplyAndAddMultipliedJoined( sampleFrame* dst, const sample_t* srcLeft, const sample_t* srcRight, float coeffDst, float coeffSrc, int frames );
 
+/*! \brief Multiply the channels of buf by left and right */
+void multiply( sampleFrame* buf, float left, float right, int frames );
+
+/*! \brief Multiply the channels of buf by coeffBuf and left or right */
+void multiplyByBuffer( sampleFrame* buf, const ValueBuffer * coeffBuf, float left, float right, int frames );
+
+/*! \brief Apply volume and linear panning (as AudioPort does) where the panning
+ *  comes from panningBuf, scaled by panningScale. The volume is volumeBuf
+ *  scaled by volume, or just volume if volumeBuf is null. */
+void multiplyByPanningBuffer( sampleFrame* buf, const ValueBuffer * volumeBuf, float volume,
+				const ValueBuffer * panningBuf, float panningScale, int frames );
+
 } // namespace MixHelpers
 
 
@@ -0,0 +1,68 @@
+/*
+ * MixHelpersKernels.h - instruction set specific implementations of the
+ *                       MixHelpers primitives
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef MIX_HELPERS_KERNELS_H
+#define MIX_HELPERS_KERNELS_H
+
+// This header is shared by translation units which are compiled for
+// different instruction sets. It must not pull in anything with inline
+// functions, or the linker might pick an AVX copy for the scalar code.
+
+namespace lmms::MixHelpers
+{
+
+//! Table of the primitives which are worth vectorising. All buffers are
+//! interleaved stereo, i.e. 2 * frames floats.
+struct Kernels
+{
+	void ( *add )( float* dst, const float* src, int frames );
+	void ( *addMultiplied )( float* dst, const float* src, float coeff, int frames );
+	void ( *addSanitizedMultiplied )( float* dst, const float* src, float coeff, int frames );
+	//! coeffBuf2 may be null
+	void ( *addMultipliedByBuffers )( float* dst, const float* src, float coeff,
+				const float* coeffBuf1, const float* coeffBuf2, int frames );
+	//! coeffBuf2 may be null
+	void ( *addSanitizedMultipliedByBuffers )( float* dst, const float* src, float coeff,
+				const float* coeffBuf1, const float* coeffBuf2, int frames );
+	bool ( *sanitize )( float* buf, int frames );
+	bool ( *isSilent )( const float* src, int frames );
+	void ( *peak )( const float* src, int frames, float* left, float* right );
+	void ( *multiply )( float* buf, float left, float right, int frames );
+	void ( *multiplyByBuffer )( float* buf, const float* coeffBuf,
+				float left, float right, int frames );
+	//! volumeBuf may be null
+	void ( *multiplyByPanningBuffer )( float* buf, const float* volumeBuf, float volume,
+				const float* panningBuf, float panningScale, int frames );
+} ;
+
+// each of these returns null if the build does not support the
+// instruction set - the caller still has to check the CPU
+const Kernels* sse2Kernels();
+const Kernels* avx2Kernels();
+const Kernels* avx512Kernels();
+
+} // namespace lmms::MixHelpers
+
+#endif
@@ -0,0 +1,339 @@
+/*
+ * MixHelpersSimd.h - MixHelpers kernels, generic over the vector type
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef MIX_HELPERS_SIMD_H
+#define MIX_HELPERS_SIMD_H
+
+// Only to be included by the MixHelpers<Isa>.cpp files, after they defined
+// their vector traits. Everything in here has internal linkage, so each of
+// them gets its own copy compiled for its instruction set.
+//
+// A vector traits class V provides:
+//   Reg, Mask                  register and comparison mask types
+//   Width                      number of floats per register (even)
+//   load, store                unaligned access
+//   set1( x ), setPair( l, r ) broadcast x, or l and r alternating
+//   loadDup( p )               p[0], p[0], p[1], p[1], ... (Width / 2 values)
+//   zero, add, mul, min, abs   the obvious
+//   max( a, b )                a > b ? a : b, per lane (so NaN in a is dropped)
+//   badMask( x )               lanes which are inf or NaN
+//   geMask( a, b )             lanes where a >= b
+//   zeroIf( m, x )             x with the lanes in m set to 0
+//   noMask, orMask, anyMask    mask helpers
+
+#include <cstdint>
+#include <cstring>
+
+#include "MixHelpersKernels.h"
+
+namespace lmms::MixHelpers
+{
+
+namespace
+{
+
+inline bool isBad( float x )
+{
+	std::uint32_t bits;
+	std::memcpy( &bits, &x, sizeof( bits ) );
+	return ( bits & 0x7f800000u ) == 0x7f800000u;
+}
+
+
+
+
+template<class V>
+void add( float* dst, const float* src, int frames )
+{
+	const int n = frames * 2;
+	int i = 0;
+	for( ; i + V::Width <= n; i += V::Width )
+	{
+		V::store( dst + i, V::add( V::load( dst + i ), V::load( src + i ) ) );
+	}
+	for( ; i < n; ++i )
+	{
+		dst[i] += src[i];
+	}
+}
+
+
+
+
+template<class V, bool Sanitize>
+void addMultiplied( float* dst, const float* src, float coeff, int frames )
+{
+	const int n = frames * 2;
+	const typename V::Reg c = V::set1( coeff );
+	int i = 0;
+	for( ; i + V::Width <= n; i += V::Width )
+	{
+		const typename V::Reg s = V::load( src + i );
+		typename V::Reg p = V::mul( s, c );
+		if( Sanitize )
+		{
+			p = V::zeroIf( V::badMask( s ), p );
+		}
+		V::store( dst + i, V::add( V::load( dst + i ), p ) );
+	}
+	for( ; i < n; ++i )
+	{
+		dst[i] += ( Sanitize && isBad( src[i] ) ) ? 0.0f : src[i] * coeff;
+	}
+}
+
+
+
+
+template<class V, bool Sanitize>
+void addMultipliedByBuffers( float* dst, const float* src, float coeff,
+				const float* coeffBuf1, const float* coeffBuf2, int frames )
+{
+	const int n = frames * 2;
+	const typename V::Reg c = V::set1( coeff );
+	int i = 0;
+	for( ; i + V::Width <= n; i += V::Width )
+	{
+		typename V::Reg gain = V::mul( c, V::loadDup( coeffBuf1 + i / 2 ) );
+		if( coeffBuf2 )
+		{
+			gain = V::mul( gain, V::loadDup( coeffBuf2 + i / 2 ) );
+		}
+		const typename V::Reg s = V::load( src + i );
+		typename V::Reg p = V::mul( s, gain );
+		if( Sanitize )
+		{
+			p = V::zeroIf( V::badMask( s ), p );
+		}
+		V::store( dst + i, V::add( V::load( dst + i ), p ) );
+	}
+	for( ; i < n; ++i )
+	{
+		const int f = i / 2;
+		const float gain = coeff * coeffBuf1[f] * ( coeffBuf2 ? coeffBuf2[f] : 1.0f );
+		dst[i] += ( Sanitize && isBad( src[i] ) ) ? 0.0f : src[i] * gain;
+	}
+}
+
+
+
+
+template<class V>
+bool sanitize( float* buf, int frames )
+{
+	const int n = frames * 2;
+	const typename V::Reg lo = V::set1( -1000.0f );
+	const typename V::Reg hi = V::set1( 1000.0f );
+
+	// clamp and look for infs/nans in the same pass - the clamped values
+	// are thrown away if there were any
+	typename V::Mask bad = V::noMask();
+	int i = 0;
+	for( ; i + V::Width <= n; i += V::Width )
+	{
+		const typename V::Reg x = V::load( buf + i );
+		bad = V::orMask( bad, V::badMask( x ) );
+		V::store( buf + i, V::min( V::max( x, lo ), hi ) );
+	}
+	bool found = V::anyMask( bad );
+	for( ; i < n && ! found; ++i )
+	{
+		if( isBad( buf[i] ) )
+		{
+			found = true;
+		}
+		else
+		{
+			buf[i] = buf[i] < -1000.0f ? -1000.0f : ( buf[i] > 1000.0f ? 1000.0f : buf[i] );
+		}
+	}
+
+	if( found )
+	{
+		std::memset( buf, 0, sizeof( float ) * n );
+	}
+	return found;
+}
+
+
+
+
+template<class V>
+bool isSilent( const float* src, int frames )
+{
+	const float silenceThreshold = 0.0000001f;
+	const int n = frames * 2;
+	const typename V::Reg threshold = V::set1( silenceThreshold );
+	int i = 0;
+	for( ; i + V::Width <= n; i += V::Width )
+	{
+		if( V::anyMask( V::geMask( V::abs( V::load( src + i ) ), threshold ) ) )
+		{
+			return false;
+		}
+	}
+	for( ; i < n; ++i )
+	{
+		if( ( src[i] < 0 ? -src[i] : src[i] ) >= silenceThreshold )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+
+template<class V>
+void peak( const float* src, int frames, float* left, float* right )
+{
+	const int n = frames * 2;
+	typename V::Reg acc = V::zero();
+	int i = 0;
+	for( ; i + V::Width <= n; i += V::Width )
+	{
+		acc = V::max( V::abs( V::load( src + i ) ), acc );
+	}
+
+	float lanes[V::Width];
+	V::store( lanes, acc );
+	float l = *left;
+	float r = *right;
+	for( int k = 0; k < V::Width; k += 2 )
+	{
+		l = lanes[k] > l ? lanes[k] : l;
+		r = lanes[k + 1] > r ? lanes[k + 1] : r;
+	}
+	for( ; i < n; i += 2 )
+	{
+		const float absLeft = src[i] < 0 ? -src[i] : src[i];
+		const float absRight = src[i + 1] < 0 ? -src[i + 1] : src[i + 1];
+		l = absLeft > l ? absLeft : l;
+		r = absRight > r ? absRight : r;
+	}
+	*left = l;
+	*right = r;
+}
+
+
+
+
+template<class V>
+void multiply( float* buf, float left, float right, int frames )
+{
+	const int n = frames * 2;
+	const typename V::Reg gain = V::setPair( left, right );
+	int i = 0;
+	for( ; i + V::Width <= n; i += V::Width )
+	{
+		V::store( buf + i, V::mul( V::load( buf + i ), gain ) );
+	}
+	for( ; i < n; i += 2 )
+	{
+		buf[i] *= left;
+		buf[i + 1] *= right;
+	}
+}
+
+
+
+
+template<class V>
+void multiplyByBuffer( float* buf, const float* coeffBuf, float left, float right, int frames )
+{
+	const int n = frames * 2;
+	const typename V::Reg channels = V::setPair( left, right );
+	int i = 0;
+	for( ; i + V::Width <= n; i += V::Width )
+	{
+		const typename V::Reg gain = V::mul( V::loadDup( coeffBuf + i / 2 ), channels );
+		V::store( buf + i, V::mul( V::load( buf + i ), gain ) );
+	}
+	for( ; i < n; i += 2 )
+	{
+		buf[i] *= coeffBuf[i / 2] * left;
+		buf[i + 1] *= coeffBuf[i / 2] * right;
+	}
+}
+
+
+
+
+template<class V>
+void multiplyByPanningBuffer( float* buf, const float* volumeBuf, float volume,
+				const float* panningBuf, float panningScale, int frames )
+{
+	// left gain is min( 1, 1 - p ), right gain is min( 1, 1 + p )
+	const int n = frames * 2;
+	const typename V::Reg one = V::set1( 1.0f );
+	const typename V::Reg sign = V::setPair( -1.0f, 1.0f );
+	const typename V::Reg scale = V::set1( panningScale );
+	const typename V::Reg vol = V::set1( volume );
+	int i = 0;
+	for( ; i + V::Width <= n; i += V::Width )
+	{
+		const typename V::Reg p = V::mul( V::loadDup( panningBuf + i / 2 ), scale );
+		const typename V::Reg pan = V::min( one, V::add( one, V::mul( sign, p ) ) );
+		const typename V::Reg v = volumeBuf
+			? V::mul( V::loadDup( volumeBuf + i / 2 ), vol )
+			: vol;
+		V::store( buf + i, V::mul( V::load( buf + i ), V::mul( pan, v ) ) );
+	}
+	for( ; i < n; i += 2 )
+	{
+		const int f = i / 2;
+		const float p = panningBuf[f] * panningScale;
+		const float v = volumeBuf ? volumeBuf[f] * volume : volume;
+		buf[i] *= ( p <= 0 ? 1.0f : 1.0f - p ) * v;
+		buf[i + 1] *= ( p >= 0 ? 1.0f : 1.0f + p ) * v;
+	}
+}
+
+
+
+
+template<class V>
+constexpr Kernels makeKernels()
+{
+	return Kernels {
+		&add<V>,
+		&addMultiplied<V, false>,
+		&addMultiplied<V, true>,
+		&addMultipliedByBuffers<V, false>,
+		&addMultipliedByBuffers<V, true>,
+		&sanitize<V>,
+		&isSilent<V>,
+		&peak<V>,
+		&multiply<V>,
+		&multiplyByBuffer<V>,
+		&multiplyByPanningBuffer<V>
+	};
+}
+
+} // namespace
+
+} // namespace lmms::MixHelpers
+
+#endif
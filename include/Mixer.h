@@ -26,11 +26,13 @@
 #define MIXER_H
 
 #include "Model.h"
+#include "CompensationDelay.h"
 #include "EffectChain.h"
 #include "JournallingObject.h"
 #include "ThreadableJob.h"
 
 #include <atomic>
+#include <vector>
 
 #include <QColor>
 
@@ -64,7 +66,6 @@ class MixerChannel : public ThreadableJob
 		QString m_name;
 		QMutex m_lock;
 		int m_channelIndex; // what channel index are we
-		bool m_queued; // are we queued up for rendering yet?
 		bool m_muted; // are we muted? updated per period so we don't have to call m_muteModel.value() twice
 
 		// pointers to other channels that this one sends to
@@ -87,13 +88,32 @@ class MixerChannel : public ThreadableJob
 		QColor m_color;
 		bool m_hasColor;
 
-	
-		std::atomic_int m_dependenciesMet;
-		void incrementDeps();
-		void processed();
-		
+		// buffer fed to this channel by mixToChannel, summed up when the
+		// channel gets processed
+		struct Input
+		{
+			int order;
+			const sampleFrame * buffer;
+		} ;
+
+		// register an input buffer without blocking - thread-safe
+		void addInput( const sampleFrame * buf, int order );
+
+		// make room for count inputs - allocates, so it must be called
+		// while the audio engine is paused
+		void reserveInputs( int count );
+		// forget the inputs of the last period
+		void clearInputs()
+		{
+			m_numInputs = 0;
+		}
+
 	private:
 		void doProcessing() override;
+		void mixInputs( fpp_t fpp );
+
+		std::vector<Input> m_inputs;
+		std::atomic_int m_numInputs;
 };
 
 
@@ -128,6 +148,13 @@ class MixerRoute : public QObject
 	{
 		return m_to;
 	}
+
+	// delays the sender's output so it lines up with the other inputs of
+	// the receiver
+	CompensationDelay & compensationDelay()
+	{
+		return m_compensationDelay;
+	}
 	
 	void updateName();
 		
@@ -135,6 +162,7 @@ class MixerRoute : public QObject
 		MixerChannel * m_from;
 		MixerChannel * m_to;
 		FloatModel m_amount;
+		CompensationDelay m_compensationDelay;
 };
 
 
@@ -145,7 +173,9 @@ public:
 	Mixer();
 	~Mixer() override;
 
-	void mixToChannel( const sampleFrame * _buf, mix_ch_t _ch );
+	// add _buf to the input of channel _ch. The inputs of a channel are
+	// summed in ascending _order, independent of which thread added them.
+	void mixToChannel( const sampleFrame * _buf, mix_ch_t _ch, int _order );
 
 	void prepareMasterMix();
 	void masterMix( sampleFrame * _buf );
@@ -213,10 +243,44 @@ public:
 
 	MixerRouteVector m_mixerRoutes;
 
+	// make room for the inputs of count audio ports in every channel, so
+	// mixToChannel() never runs out of slots - must be called while the
+	// audio engine is paused
+	void reserveChannelInputs( int count );
+
+public slots:
+	// recompute the plugin delay compensation soon - may be called from any
+	// thread, including the audio thread
+	void requestLatencyUpdate();
+
+private slots:
+	// does the update requested by requestLatencyUpdate(), if any
+	void applyLatencyUpdate();
+
+signals:
+	// emitted once per pending update, queued to the main thread
+	void latencyUpdateRequested();
+
 private:
 	// the mixer channels in the mixer. index 0 is always master.
 	QVector<MixerChannel *> m_mixerChannels;
 
+	// the channels grouped by their depth in the route graph: a channel only
+	// receives from channels of lower levels, so each level can be processed
+	// in parallel once the previous one is done
+	QVector<QVector<MixerChannel *>> m_mixLevels;
+
+	// recompute m_mixLevels - must be called with the audio engine locked
+	// whenever channels or routes are added or removed
+	void rebuildMixLevels();
+
+	// set the compensation delays of all audio ports and routes so that
+	// all signals arriving at a channel are aligned to its slowest input
+	void updateLatencyCompensation();
+
+	// the update allocates, so it is usually done by the main thread
+	std::atomic_bool m_latencyChanged;
+
 	// make sure we have at least num channels
 	void allocateChannelsTo(int num);
 
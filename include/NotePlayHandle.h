@@ -34,8 +34,6 @@
 #include "Track.h"
 #include "MemoryManager.h"
 
-class QReadWriteLock;
-
 namespace lmms
 {
 
@@ -332,12 +330,20 @@ private:
 	Origin m_origin;
 
 	bool m_frequencyNeedsUpdate;				// used to update pitch
+
+	int m_poolIndex;						// set by NotePlayHandleManager
+
+	friend class NotePlayHandleManager;
 } ;
 
 
 const int INITIAL_NPH_CACHE = 256;
-const int NPH_CACHE_INCREMENT = 16;
+const int NPH_CACHE_INCREMENT = 64;
 
+//! Pool of NotePlayHandles which doesn't lock. Every thread keeps a few
+//! free handles for itself and exchanges them with a lock-free list shared
+//! by all threads. A background thread allocates more handles before the
+//! pool runs out, so acquire() only allocates if it couldn't keep up.
 class NotePlayHandleManager
 {
 	MM_OPERATORS
@@ -351,14 +357,14 @@ public:
 					int midiEventChannel = -1,
 					NotePlayHandle::Origin origin = NotePlayHandle::OriginMidiClip );
 	static void release( NotePlayHandle * nph );
-	static void extend( int i );
+	//! Allocate handles until there are at least count of them
+	static void reserve( int count );
 	static void free();
 
-private:
-	static NotePlayHandle ** s_available;
-	static QReadWriteLock s_mutex;
-	static std::atomic_int s_availableIndex;
-	static int s_size;
+	//! Number of handles allocated so far
+	static int size();
+	//! How often acquire() found the pool empty and had to allocate
+	static int misses();
 };
 
 
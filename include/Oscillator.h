@@ -251,7 +251,8 @@ private:
 	bool m_isModulator;
 
 	/* Multiband WaveTable */
-	static sample_t s_waveTables[WaveShapes::NumWaveShapeTables][OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT][OscillatorConstants::WAVETABLE_LENGTH];
+	// points into the memory mapped cache file or to the generated tables
+	static sample_t (*s_waveTables)[OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT][OscillatorConstants::WAVETABLE_LENGTH];
 	static fftwf_plan s_fftPlan;
 	static fftwf_plan s_ifftPlan;
 	static fftwf_complex * s_specBuf;
@@ -263,6 +264,8 @@ private:
 	static void generateFromFFT(int bands, sample_t* table);
 	static void generateWaveTables();
 	static void createFFTPlans();
+	static bool loadWaveTableCache();
+	static void saveWaveTableCache();
 
 	/* End Multiband wavetable */
 
@@ -303,8 +306,31 @@ private:
 	void updateFM( sampleFrame * _ab, const fpp_t _frames,
 							const ch_cnt_t _chnl );
 
+	//! Frames rendered at once by the update*() kernels
+	static constexpr int BlockSize = 64;
+
+	//! Calls nextPhase( frame ) for the frames of a block, renders the wave at
+	//! these phases and hands the samples to store( frame, sample )
+	template<WaveShapes W, typename PhaseFn, typename StoreFn>
+	inline void renderBlocks( const fpp_t _frames, PhaseFn nextPhase, StoreFn store );
+
+	//! Renders the wave at count phases. Whatever stays the same during a
+	//! period, like the wavetable band, is only looked up once.
 	template<WaveShapes W>
-	inline sample_t getSample( const float _sample );
+	inline void getSamples( const float * phases, sample_t * samples, const int count );
+
+	template<sample_t SHAPE( const float )>
+	inline void bandLimitedSamples( const int table, const float * phases,
+						sample_t * samples, const int count );
+
+	static inline void wtSamples( const sample_t * table, const float * phases,
+						sample_t * samples, const int count );
+
+	inline int waveTableBand() const
+	{
+		return waveTableBandFromFreq(
+			m_freq * m_detuning_div_samplerate * Engine::audioEngine()->processingSampleRate());
+	}
 
 	inline void recalcPhase();
 
@@ -93,7 +93,7 @@ public:
 	void fixIncorrectPositions();
 	void createClipsForPattern(int pattern);
 
-	AutomatedValueMap automatedValuesAt(TimePos time, int clipNum) const override;
+	void visitAutomation(TimePos time, int clipNum, const AutomationVisitor& visit) const override;
 
 public slots:
 	void play();
@@ -28,6 +28,8 @@
 #include <QStringList>
 #include <QMap>
 
+#include <atomic>
+
 #include "JournallingObject.h"
 #include "Model.h"
 #include "MemoryManager.h"
@@ -294,7 +296,22 @@ public:
 	//! Create a view for the model
 	gui::PluginView * createView( QWidget * parent );
 
+	//! Return the processing latency in frames at the processing sample
+	//! rate, i.e. how much later a signal leaves the plugin than it went in
+	inline f_cnt_t latency() const
+	{
+		return m_latency;
+	}
+
 protected:
+	//! Report the plugin's processing latency. Cheap if the value did not
+	//! change, so it may be called once per period from the audio thread.
+	void setLatency( f_cnt_t frames );
+
+	//! Called after the latency changed. The default implementation makes
+	//! the mixer recompute its delay compensation.
+	virtual void latencyChanged();
+
 	//! Create a view for the model
 	virtual gui::PluginView* instantiateView( QWidget * ) = 0;
 	void collectErrorForUI( QString errMsg );
@@ -305,6 +322,8 @@ private:
 
 	Descriptor::SubPluginFeatures::Key m_key;
 
+	std::atomic<f_cnt_t> m_latency;
+
 	// pointer to instantiation-function in plugin
 	using InstantiationHook = Plugin* (*)(Model*, void*);
 } ;
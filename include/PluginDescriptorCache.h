@@ -0,0 +1,80 @@
+/*
+ * PluginDescriptorCache.h - remembers what was found out about plugin files
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef PLUGIN_DESCRIPTOR_CACHE_H
+#define PLUGIN_DESCRIPTOR_CACHE_H
+
+#include <QByteArray>
+#include <QFileInfo>
+#include <QHash>
+#include <QString>
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+/// Keeps whatever the plugin managers found out about a plugin file between
+/// runs, so they don't need to load every library at startup. An entry is
+/// only handed out while the file still has the size and modification time
+/// it was stored with. The cache is dropped completely with every new LMMS
+/// version, and entries which weren't used during a run are not saved again.
+class LMMS_EXPORT PluginDescriptorCache
+{
+public:
+	//! name is the file name within ConfigManager::cacheDir()
+	PluginDescriptorCache( const QString & name );
+	//! Saves the cache if anything changed
+	~PluginDescriptorCache();
+
+	//! The data stored for file, or a null QByteArray if there's none or the
+	//! file changed since
+	QByteArray find( const QFileInfo & file );
+	void insert( const QFileInfo & file, const QByteArray & data );
+
+	void save();
+
+private:
+	struct Entry
+	{
+		qint64 size;
+		qint64 modified;
+		QByteArray data;
+	} ;
+
+	using EntryMap = QHash<QString, Entry>;
+
+	void load();
+
+	const QString m_path;
+	EntryMap m_entries;
+	//! The entries used during this run, which will be saved
+	EntryMap m_used;
+	bool m_changed;
+} ;
+
+
+} // namespace lmms
+
+#endif
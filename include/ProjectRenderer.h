@@ -71,6 +71,11 @@ public:
 		return m_fileDev != nullptr;
 	}
 
+	QString outputFile() const
+	{
+		return m_fileDev ? m_fileDev->outputFile() : QString();
+	}
+
 	static ExportFileFormats getFileFormatFromExtension(
 							const QString & _ext );
 
@@ -78,6 +83,18 @@ public:
 
 	static const FileEncodeDevice fileEncodeDevices[];
 
+	//! Length of the rendered audio in seconds, valid after finished()
+	double renderedSeconds() const
+	{
+		return m_renderedSeconds;
+	}
+
+	//! Wall clock time the render took in seconds, valid after finished()
+	double renderTime() const
+	{
+		return m_renderTime;
+	}
+
 public slots:
 	void startProcessing();
 	void abortProcessing();
@@ -98,6 +115,9 @@ private:
 	volatile int m_progress;
 	volatile bool m_abort;
 
+	double m_renderedSeconds;
+	double m_renderTime;
+
 } ;
 
 
@@ -98,8 +98,22 @@ public:
 
 	bool process( const sampleFrame * _in_buf, sampleFrame * _out_buf );
 
+	//! In pipelined mode, process() hands the current period to the plugin
+	//! and returns the output of the previous one, so both processes can
+	//! work at the same time
+	inline bool isPipelined() const
+	{
+		return m_pipelined;
+	}
+
+	//! The delay in frames which the pipeline adds to the output
+	f_cnt_t latency() const;
+
 	void processMidiEvent( const MidiEvent&, const f_cnt_t _offset );
 
+	//! Sends the messages queued with queueMessage() right away
+	void sendQueuedMessages();
+
 	void updateSampleRate( sample_rate_t _sr )
 	{
 		lock();
@@ -150,6 +164,17 @@ protected:
 		m_splitChannels = _on;
 	}
 
+	//! Sends _m together with the next period. The arguments of queued
+	//! messages with the same ID are merged into one message, so the client
+	//! has to handle several events in one message.
+	void queueMessage( const message & _m );
+
+	//! Like queueMessage(), for messages which set the value of something
+	//! identified by their first argument, e.g. a parameter. A value queued
+	//! before for the same thing is replaced, so the queue doesn't grow
+	//! while no periods are processed.
+	void queueValueMessage( const message & _m );
+
 
 	bool m_failed;
 private:
@@ -172,6 +197,15 @@ private:
 	SharedMemory<float[]> m_audioBuffer;
 	std::size_t m_audioBufferSize;
 
+	const bool m_pipelined;
+	//! Half of m_audioBuffer used for the next period in pipelined mode
+	int m_slot;
+	//! Periods started but not reported to be done yet
+	int m_periodsInFlight;
+
+	//! At most one message per ID, emptied but kept after sending
+	std::vector<message> m_queuedMessages;
+
 	int m_inputCount;
 	int m_outputCount;
 
@@ -27,6 +27,7 @@
 
 #include "MidiEvent.h"
 
+#include <algorithm>
 #include <atomic>
 #include <vector>
 #include <cstdio>
@@ -97,6 +98,8 @@ namespace lmms
 // sometimes we need to exchange bigger messages (e.g. for VST parameter dumps)
 // so set a usable value here
 const int SHM_FIFO_SIZE = 512*1024;
+// bigger messages are passed through the FIFO in pieces of this size
+const int SHM_FIFO_CHUNK_SIZE = SHM_FIFO_SIZE / 2;
 
 
 // implements a FIFO inside a shared memory segment
@@ -217,27 +220,23 @@ public:
 		write( &_i, sizeof( _i ) );
 	}
 
-	inline std::string readString()
+	// read and write data which might be larger than the FIFO
+	void readData( void * _buf, int _len )
 	{
-		const int len = readInt();
-		if( len )
+		char * buf = (char *) _buf;
+		for( int done = 0; done < _len; done += SHM_FIFO_CHUNK_SIZE )
 		{
-			char * sc = new char[len + 1];
-			read( sc, len );
-			sc[len] = 0;
-			std::string s( sc );
-			delete[] sc;
-			return s;
+			read( buf + done, std::min( _len - done, SHM_FIFO_CHUNK_SIZE ) );
 		}
-		return std::string();
 	}
 
-
-	inline void writeString( const std::string & _s )
+	void writeData( const void * _buf, int _len )
 	{
-		const int len = _s.size();
-		writeInt( len );
-		write( _s.c_str(), len );
+		const char * buf = (const char *) _buf;
+		for( int done = 0; done < _len; done += SHM_FIFO_CHUNK_SIZE )
+		{
+			write( buf + done, std::min( _len - done, SHM_FIFO_CHUNK_SIZE ) );
+		}
 	}
 
 
@@ -382,6 +381,8 @@ enum RemoteMessageIDs
 class LMMS_EXPORT RemotePluginBase
 {
 public:
+	// the arguments are kept in the binary form they are sent in: each one's
+	// size followed by its bytes, with numbers in the native byte order
 	struct message
 	{
 		message() :
@@ -400,46 +401,94 @@ public:
 
 		inline message & addString( const std::string & _s )
 		{
-			data.push_back( _s );
+			addArgument( _s.data(), _s.size() );
 			return *this;
 		}
 
 		message & addInt( int _i )
 		{
-			char buf[32];
-			sprintf( buf, "%d", _i );
-			data.emplace_back( buf );
+			const int32_t i = _i;
+			addArgument( &i, sizeof( i ) );
 			return *this;
 		}
 
 		message & addFloat( float _f )
 		{
-			char buf[32];
-			sprintf( buf, "%f", _f );
-			data.emplace_back( buf );
+			addArgument( &_f, sizeof( _f ) );
+			return *this;
+		}
+
+		// append the arguments of another message, e.g. to send
+		// several events at once
+		message & addArguments( const message & _m )
+		{
+			for( const uint32_t offset : _m.offsets )
+			{
+				offsets.push_back( data.size() + offset );
+			}
+			data += _m.data;
 			return *this;
 		}
 
+		// overwrite the arguments from _p on with the ones of _m, if they
+		// have the same sizes
+		bool replaceArguments( int _p, const message & _m )
+		{
+			const std::size_t n = _m.offsets.size();
+			if( _p < 0 || _p + n > offsets.size() )
+			{
+				return false;
+			}
+			const std::size_t begin = offsets[_p];
+			const std::size_t end = _p + n < offsets.size() ?
+						offsets[_p + n] : data.size();
+			if( end - begin != _m.data.size() )
+			{
+				return false;
+			}
+			for( std::size_t i = 0; i < n; ++i )
+			{
+				if( offsets[_p + i] - begin != _m.offsets[i] )
+				{
+					return false;
+				}
+			}
+			data.replace( begin, _m.data.size(), _m.data );
+			return true;
+		}
+
 		inline std::string getString( int _p = 0 ) const
 		{
-			return data[_p];
+			return std::string( argument( _p ), argumentSize( _p ) );
 		}
 
 #ifndef BUILD_REMOTE_PLUGIN_CLIENT
 		inline QString getQString( int _p = 0 ) const
 		{
-			return QString::fromStdString( getString( _p ) );
+			return QString::fromUtf8( argument( _p ), argumentSize( _p ) );
 		}
 #endif
 
 		inline int getInt( int _p = 0 ) const
 		{
-			return atoi( data[_p].c_str() );
+			return getNumber<int32_t>( _p );
 		}
 
 		inline float getFloat( int _p ) const
 		{
-			return (float) atof( data[_p].c_str() );
+			return getNumber<float>( _p );
+		}
+
+		inline int arguments() const
+		{
+			return offsets.size();
+		}
+
+		// remove all arguments but keep the memory
+		inline void clear()
+		{
+			data.clear();
+			offsets.clear();
 		}
 
 		inline bool operator==( const message & _m ) const
@@ -450,7 +499,55 @@ public:
 		int id;
 
 	private:
-		std::vector<std::string> data;
+		void addArgument( const void * _buf, int32_t _len )
+		{
+			offsets.push_back( data.size() );
+			data.append( (const char *) &_len, sizeof( _len ) );
+			data.append( (const char *) _buf, _len );
+		}
+
+		// find the arguments in data after it has been received
+		void indexArguments()
+		{
+			offsets.clear();
+			for( std::size_t offset = 0; offset + sizeof( int32_t ) <= data.size(); )
+			{
+				int32_t len;
+				memcpy( &len, data.data() + offset, sizeof( len ) );
+				if( len < 0 || offset + sizeof( len ) + len > data.size() )
+				{
+					break;
+				}
+				offsets.push_back( offset );
+				offset += sizeof( len ) + len;
+			}
+		}
+
+		inline const char * argument( int _p ) const
+		{
+			return data.data() + offsets[_p] + sizeof( int32_t );
+		}
+
+		inline int32_t argumentSize( int _p ) const
+		{
+			int32_t len;
+			memcpy( &len, data.data() + offsets[_p], sizeof( len ) );
+			return len;
+		}
+
+		template<typename T>
+		T getNumber( int _p ) const
+		{
+			T value = 0;
+			if( argumentSize( _p ) == sizeof( T ) )
+			{
+				memcpy( &value, argument( _p ), sizeof( T ) );
+			}
+			return value;
+		}
+
+		std::string data;
+		std::vector<uint32_t> offsets;
 
 		friend class RemotePluginBase;
 
@@ -507,29 +604,6 @@ public:
 	{
 		write( &_i, sizeof( _i ) );
 	}
-
-	inline std::string readString()
-	{
-		const int len = readInt();
-		if( len )
-		{
-			char * sc = new char[len + 1];
-			read( sc, len );
-			sc[len] = 0;
-			std::string s( sc );
-			delete[] sc;
-			return s;
-		}
-		return std::string();
-	}
-
-
-	inline void writeString( const std::string & _s )
-	{
-		const int len = _s.size();
-		writeInt( len );
-		write( _s.c_str(), len );
-	}
 #endif // SYNC_WITH_SHM_FIFO
 
 #ifndef BUILD_REMOTE_PLUGIN_CLIENT
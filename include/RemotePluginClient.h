@@ -122,7 +122,7 @@ public:
 
 private:
 	void setShmKey(const std::string& key);
-	void doProcessing();
+	void doProcessing( int slot );
 
 	SharedMemory<float[]> m_audioBuffer;
 	SharedMemory<const VstSyncData> m_vstSyncData;
@@ -282,17 +282,21 @@ bool RemotePluginClient::processMessage( const message & _m )
 			return false;
 
 		case IdMidiEvent:
-			processMidiEvent(
-				MidiEvent( static_cast<MidiEventTypes>(
-							_m.getInt( 0 ) ),
-						_m.getInt( 1 ),
-						_m.getInt( 2 ),
-						_m.getInt( 3 ) ),
-							_m.getInt( 4 ) );
+			// the host sends all events of a period at once
+			for( int i = 0; i + 4 < _m.arguments(); i += 5 )
+			{
+				processMidiEvent(
+					MidiEvent( static_cast<MidiEventTypes>(
+								_m.getInt( i ) ),
+							_m.getInt( i + 1 ),
+							_m.getInt( i + 2 ),
+							_m.getInt( i + 3 ) ),
+								_m.getInt( i + 4 ) );
+			}
 			break;
 
 		case IdStartProcessing:
-			doProcessing();
+			doProcessing( _m.getInt( 0 ) );
 			reply_message.id = IdProcessingDone;
 			reply = true;
 			break;
@@ -338,12 +342,16 @@ void RemotePluginClient::setShmKey(const std::string& key)
 
 
 
-void RemotePluginClient::doProcessing()
+void RemotePluginClient::doProcessing( int slot )
 {
 	if (m_audioBuffer)
 	{
-		process( (sampleFrame *)( m_inputCount > 0 ? m_audioBuffer.get() : nullptr ),
-				(sampleFrame *)( m_audioBuffer.get() +
+		// the host may use two periods worth of memory, see
+		// RemotePlugin::isPipelined()
+		float * buffer = m_audioBuffer.get() +
+			slot * ( m_inputCount + m_outputCount ) * m_bufferSize;
+		process( (sampleFrame *)( m_inputCount > 0 ? buffer : nullptr ),
+				(sampleFrame *)( buffer +
 					( m_inputCount*m_bufferSize ) ) );
 	}
 	else
@@ -0,0 +1,102 @@
+/*
+ * RenderFarm.h - renders several files at once in child processes
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef RENDER_FARM_H
+#define RENDER_FARM_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+#include <QVector>
+
+
+namespace lmms
+{
+
+
+/// Runs headless renders in separate lmms processes, because the engine and
+/// the song only exist once per process. Used for "renderfarm" and for
+/// "rendertracks --jobs".
+class RenderFarm : public QObject
+{
+	Q_OBJECT
+public:
+	struct Job
+	{
+		//! Command line of the child process, without the executable
+		QStringList arguments;
+		//! Only used for reporting
+		QString outputPath;
+	} ;
+
+	RenderFarm( const QVector<Job> & jobs, int maxProcesses, QObject * parent = nullptr );
+	~RenderFarm() override;
+
+	/// Read a manifest with one project per line, optionally followed by a
+	/// tab and the output file. Empty lines and lines starting with '#' are
+	/// skipped, relative paths are relative to the manifest. Projects without
+	/// an output file are rendered into outputDir, or next to the project if
+	/// outputDir is empty. Returns an empty list on errors.
+	static QVector<Job> jobsFromManifest( const QString & manifest,
+				const QString & outputDir, const QString & extension,
+				const QStringList & renderArguments );
+
+	void start();
+
+	int failedJobs() const
+	{
+		return m_failed;
+	}
+
+signals:
+	void finished();
+
+private slots:
+	void jobFinished( int exitCode, QProcess::ExitStatus exitStatus );
+	void jobErrored( QProcess::ProcessError error );
+
+private:
+	void startNextJob();
+	void completeJob( QProcess * process, bool exitedNormally, int exitCode );
+
+	QVector<Job> m_jobs;
+	const int m_maxProcesses;
+	int m_nextJob;
+	int m_doneJobs;
+	int m_failed;
+
+	//! Sum of what the children reported
+	double m_audioSeconds;
+
+	QElapsedTimer m_wallClock;
+	QHash<QProcess *, int> m_running;
+	QVector<QElapsedTimer> m_jobTimers;
+} ;
+
+
+} // namespace lmms
+
+#endif
@@ -51,8 +51,12 @@ public:
 	/// Export all unmuted tracks into a single file
 	void renderProject();
 
-	/// Export all unmuted tracks into individual file
-	void renderTracks();
+	/// Export all unmuted tracks into individual file, or only the one with
+	/// the given index into trackPaths()
+	void renderTracks( int stem = -1 );
+
+	/// Files renderTracks() writes to, one per track
+	QStringList trackPaths() const;
 
 	void abortProcessing();
 
@@ -65,8 +69,10 @@ private slots:
 	void updateConsoleProgress();
 
 private:
-	QString pathForTrack( const Track *track, int num );
+	static QVector<Track*> renderableTracks();
+	QString pathForTrack( const Track *track, int num ) const;
 	void restoreMutedState();
+	void reportThroughput() const;
 
 	void render( QString outputPath );
 
@@ -80,6 +86,7 @@ private:
 
 	QVector<Track*> m_tracksToRender;
 	QVector<Track*> m_unmuted;
+	int m_renderCount;
 } ;
 
 
@@ -27,6 +27,7 @@
 #define SAMPLE_BUFFER_H
 
 #include <memory>
+#include <vector>
 #include <QReadWriteLock>
 #include <QObject>
 
@@ -47,6 +48,8 @@ class QRect;
 namespace lmms
 {
 
+class SampleStream;
+
 // values for buffer margins, used for various libsamplerate interpolation modes
 // the array positions correspond to the converter_type parameter values in libsamplerate
 // if there appears problems with playback on some interpolation mode, then the value for that mode
@@ -102,6 +105,10 @@ public:
 		bool m_isBackwards;
 		SRC_STATE * m_resamplingData;
 		int m_interpolationMode;
+		//! The playback of the buffer's stream when playing a streamed
+		//! buffer, and the frame it will deliver next
+		int m_streamPlayback;
+		f_cnt_t m_streamFrame;
 
 		friend class SampleBuffer;
 
@@ -234,11 +241,27 @@ public:
 		m_sampleRate = rate;
 	}
 
+	//! For streamed buffers, this only holds the first seconds of the sample
 	inline const sampleFrame * data() const
 	{
 		return m_data;
 	}
 
+	//! Whether the sample is played from disk instead of from memory
+	bool isStreamed() const
+	{
+		return m_streamed;
+	}
+
+	//! Allows playing long files from disk, which lifts the limits on their
+	//! size and length. Streamed buffers always play at their original pitch
+	//! and without loops, and only keep an overview for visualize() and the
+	//! first seconds of the sample in memory. Takes effect on the next load.
+	void setStreamable(bool streamable)
+	{
+		m_streamable = streamable;
+	}
+
 	QString openAudioFile() const;
 	QString openAndSetAudioFile();
 	QString openAndSetWaveformFile();
@@ -294,6 +317,20 @@ private:
 	static sample_rate_t audioEngineSampleRate();
 
 	void update(bool keepSettings = false);
+	struct StreamedSample;
+	//! Reads all of the file, doesn't touch the buffer
+	static bool loadStreamed(const QString & file, bool reversed, StreamedSample & sample);
+	//! Reads the first frames of the file into head, which is all a streamed
+	//! sample needs from it when it's reversed
+	static bool loadStreamedHead(const QString & file, bool reversed, f_cnt_t frames,
+					sampleFrame * head);
+	bool playStreamed(sampleFrame * ab, handleState * state, const fpp_t frames);
+
+	//! Number of frames in m_data
+	f_cnt_t dataFrames() const
+	{
+		return m_streamed ? m_headFrames : m_frames;
+	}
 
 	void convertIntToFloat(int_sample_t * & ibuf, f_cnt_t frames, int channels);
 	void directFloatWrite(sample_t * & fbuf, f_cnt_t frames, int channels);
@@ -334,6 +371,33 @@ private:
 	float m_frequency;
 	sample_rate_t m_sampleRate;
 
+	// min, max and mean square of both channels per block of OverviewFrames
+	struct OverviewPoint
+	{
+		float min;
+		float max;
+		float meanSquare;
+	} ;
+	static constexpr f_cnt_t OverviewFrames = 1024;
+	//! How much of a streamed sample is kept in memory
+	static constexpr int HeadSeconds = 5;
+
+	//! What loadStreamed() reads, so it can be swapped in at once
+	struct StreamedSample
+	{
+		sampleFrame * head = nullptr;
+		f_cnt_t headFrames = 0;
+		f_cnt_t frames = 0;
+		std::vector<OverviewPoint> overview;
+	} ;
+
+	bool m_streamable;
+	bool m_streamed;
+	f_cnt_t m_headFrames;
+	std::vector<OverviewPoint> m_overview;
+	//! Reads ahead when playing a streamed buffer
+	SampleStream * m_stream;
+
 	sampleFrame * getSampleFragment(
 		f_cnt_t index,
 		f_cnt_t frames,
@@ -0,0 +1,170 @@
+/*
+ * SampleStream.h - plays sound files from disk instead of from memory
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef SAMPLE_STREAM_H
+#define SAMPLE_STREAM_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QFile>
+#include <QString>
+
+#include <samplerate.h>
+#include <sndfile.h>
+
+#include "lmms_export.h"
+#include "lmms_basics.h"
+#include "LocklessRingBuffer.h"
+
+namespace lmms
+{
+
+class SampleStreamer;
+
+
+//! Decodes a sound file piece by piece and converts it to stereo at the
+//! given sample rate. Frame positions are counted at that rate, and from the
+//! end of the file if it is read reversed.
+class LMMS_EXPORT SampleFileReader
+{
+public:
+	SampleFileReader( const QString & file, bool reversed, sample_rate_t sampleRate );
+	~SampleFileReader();
+
+	bool isOpen() const
+	{
+		return m_sndFile != nullptr;
+	}
+
+	//! Length of the file, converted to the sample rate
+	f_cnt_t frames() const
+	{
+		return m_frames;
+	}
+
+	void seek( f_cnt_t frame );
+
+	//! Returns how many frames were read, less than frames only at the end
+	f_cnt_t read( sampleFrame * dst, f_cnt_t frames );
+
+private:
+	//! Decodes the next frames of the file into m_input
+	void readInput();
+
+	QFile m_file;
+	SNDFILE * m_sndFile;
+	SF_INFO m_info;
+	const bool m_reversed;
+	double m_ratio;
+	f_cnt_t m_frames;
+	SRC_STATE * m_resampler;
+
+	//! Next frame to decode, counted in the file's sample rate
+	sf_count_t m_filePos;
+	std::vector<float> m_fileBuffer;
+	std::vector<sampleFrame> m_input;
+	f_cnt_t m_inputPos;
+	f_cnt_t m_inputFrames;
+	bool m_endOfInput;
+} ;
+
+
+
+
+//! Plays a sound file from disk. A background thread reads the file ahead of
+//! the playback position into a lock-free ring buffer, so the audio thread
+//! never waits for the disk, and memory use does not depend on the length of
+//! the file. One playback is served at a time, starting another one takes
+//! the stream over.
+class LMMS_EXPORT SampleStream
+{
+public:
+	//! Allocates the ring buffer, so it's not for the audio thread
+	static SampleStream * create( const QString & file, bool reversed );
+
+	//! Stops reading, the stream must not be used afterwards
+	void release();
+
+	//! Starts a playback from frame from, counted at the engine's sample
+	//! rate, and returns its id for read(). Only signals the streamer
+	//! thread, so it's meant for the audio thread.
+	int start( f_cnt_t from );
+
+	//! Whether playback is the one the stream serves
+	bool isPlaying( int playback ) const
+	{
+		return m_playback.load( std::memory_order_relaxed ) == playback;
+	}
+
+	//! Fills dst with the next frames of the given playback. Frames which
+	//! were not read in time are silent and skipped once the streamer thread
+	//! catches up, unless wait is set, which is meant for rendering.
+	void read( int playback, sampleFrame * dst, f_cnt_t frames, bool wait );
+
+private:
+	SampleStream( const QString & file, bool reversed, f_cnt_t bufferFrames );
+	~SampleStream() = default;
+
+	//! Called by the streamer thread, returns whether there is more to read
+	bool fill();
+	//! Called by the streamer thread, moves the reader to the new playback
+	bool seek( f_cnt_t from );
+	//! Called by the reader, drops what was read for earlier playbacks
+	void flush();
+
+	const QString m_file;
+	const bool m_reversed;
+
+	// only used by the streamer thread
+	std::unique_ptr<SampleFileReader> m_fileReader;
+	sample_rate_t m_fileReaderRate;
+	std::vector<sampleFrame> m_chunk;
+	SampleStream * m_next;
+	int m_serving;
+
+	// only used by the reader
+	f_cnt_t m_missed;
+
+	LocklessRingBuffer<sampleFrame> m_buffer;
+	LocklessRingBufferReader<sampleFrame> m_bufferReader;
+	//! The latest playback and where it starts, set by start()
+	std::atomic<int> m_playback;
+	std::atomic<f_cnt_t> m_from;
+	//! The streamer thread only writes for a new playback after the reader
+	//! dropped what was written before
+	std::atomic<int> m_flushRequest;
+	std::atomic<int> m_flushed;
+	//! The playback for which the end of the file was read
+	std::atomic<int> m_endOfPlayback;
+	std::atomic<bool> m_released;
+
+	friend class SampleStreamer;
+} ;
+
+
+} // namespace lmms
+
+#endif
@@ -26,6 +26,9 @@
 #define SAMPLE_TRACK_H
 
 
+#include <atomic>
+#include <vector>
+
 #include "AudioPort.h"
 #include "Track.h"
 
@@ -33,6 +36,8 @@
 namespace lmms
 {
 
+class SampleClip;
+
 namespace gui
 {
 
@@ -99,6 +104,11 @@ private:
 	IntModel m_mixerChannelModel;
 	AudioPort m_audioPort;
 	bool m_isPlaying;
+	//! The clips marked as playing, so play() doesn't have to check every
+	//! clip of the track to stop them. Only play() touches it, the other
+	//! threads set m_playingClipsChanged to have it collected again.
+	std::vector<SampleClip *> m_playingClips;
+	std::atomic<bool> m_playingClipsChanged;
 
 
 
@@ -98,6 +98,7 @@ private slots:
 	void vstEmbedMethodChanged();
 	void toggleVSTAlwaysOnTop(bool en);
 	void toggleDisableAutoQuit(bool enabled);
+	void togglePipelinedRemotePlugins(bool enabled);
 
 	// Audio settings widget.
 	void audioInterfaceChanged(const QString & driver);
@@ -164,6 +165,7 @@ private:
 	LedCheckBox * m_vstAlwaysOnTopCheckBox;
 	bool m_vstAlwaysOnTop;
 	bool m_disableAutoQuit;
+	bool m_pipelinedRemotePlugins;
 
 	using AswMap = QMap<QString, AudioDeviceSetupWidget*>;
 	using MswMap = QMap<QString, MidiSetupWidget*>;
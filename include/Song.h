@@ -290,8 +290,7 @@ public:
 		return m_globalAutomationTrack;
 	}
 
-	//TODO: Add Q_DECL_OVERRIDE when Qt4 is dropped
-	AutomatedValueMap automatedValuesAt(TimePos time, int clipNum = -1) const override;
+	void visitAutomation(TimePos time, int clipNum, const AutomationVisitor& visit) const override;
 
 	// file management
 	void createNewProject();
@@ -440,7 +439,9 @@ private:
 	void saveKeymapStates(QDomDocument &doc, QDomElement &element);
 	void restoreKeymapStates(const QDomElement &element);
 
-	void processAutomations(const TrackList& tracks, TimePos timeStart, fpp_t frames);
+	TrackContainer* collectAutomations(const TrackList& tracks, TimePos time);
+	void processAutomations(const TrackList& tracks, TimePos timeStart, f_cnt_t frameOffsetInPeriod);
+	void continueAutomations(const TrackList& tracks, TimePos time, float ticksIntoTick);
 
 	void setModified(bool value);
 
@@ -502,7 +503,21 @@ private:
 	std::shared_ptr<Scale> m_scales[MaxScaleCount];
 	std::shared_ptr<Keymap> m_keymaps[MaxKeymapCount];
 
-	AutomatedValueMap m_oldAutomatedValues;
+	//! Where the models automated in the last tick get their values from.
+	//! It's kept from tick to tick, so the set of models only changes when
+	//! a model starts or stops being automated.
+	struct AutomatedModel
+	{
+		//! only valid right after collectAutomations()
+		const AutomationClip* clip = nullptr;
+		float tick = 0;
+		float endTick = 0;
+		//! see AutomationCurve::valueAt()
+		int cursor = 0;
+		//! whether collectAutomations() found it
+		bool current = false;
+	} ;
+	QHash<AutomatableModel*, AutomatedModel> m_automatedModels;
 
 	friend class Engine;
 	friend class gui::SongEditor;
@@ -29,7 +29,10 @@
 #include <QVector>
 #include <QColor>
 
+#include <atomic>
+
 #include "AutomatableModel.h"
+#include "ClipIndex.h"
 #include "JournallingObject.h"
 #include "lmms_basics.h"
 
@@ -136,6 +139,9 @@ public:
 	}
 	void getClipsInRange( clipVector & clipV, const TimePos & start,
 							const TimePos & end );
+	//! Has to be called whenever a clip of this track is added or removed,
+	//! moves or changes its length
+	void clipPositionChanged();
 	void swapPositionOfClips( int clipNum1, int clipNum2 );
 
 	void createClipsForPattern(int pattern);
@@ -238,6 +244,10 @@ private:
 	bool m_simpleSerializingMode;
 
 	clipVector m_clips;
+	//! only used while m_clipIndexValid is set, see clipPositionChanged()
+	ClipIndex m_clipIndex;
+	std::atomic<bool> m_clipIndexValid;
+	std::atomic<bool> m_clipIndexUpdatePending;
 
 	QMutex m_processingLock;
 	
@@ -247,6 +257,9 @@ private:
 	friend class gui::TrackView;
 
 
+private slots:
+	void updateClipIndex();
+
 signals:
 	void destroyedTrack();
 	void nameChanged();
@@ -27,6 +27,7 @@
 #define TRACK_CONTAINER_H
 
 #include <QReadWriteLock>
+#include <functional>
 
 #include "Track.h"
 #include "JournallingObject.h"
@@ -101,13 +102,21 @@ public:
 		return m_TrackContainerType;
 	}
 
-	virtual AutomatedValueMap automatedValuesAt(TimePos time, int clipNum = -1) const;
+	//! Called for every automation clip in effect, in the order in which they
+	//! take precedence, with the tick within the clip and the tick from which
+	//! on the clip holds its value
+	using AutomationVisitor = std::function<void(const AutomationClip* clip, float tick, float endTick)>;
+
+	AutomatedValueMap automatedValuesAt(TimePos time, int clipNum = -1) const;
+	//! automatedValuesAt() without collecting the values, for the audio thread
+	virtual void visitAutomation(TimePos time, int clipNum, const AutomationVisitor& visit) const;
 
 signals:
 	void trackAdded( lmms::Track * _track );
 
 protected:
-	static AutomatedValueMap automatedValuesFromTracks(const TrackList &tracks, TimePos timeStart, int clipNum = -1);
+	static void visitAutomationOfTracks(const TrackList &tracks, TimePos time, int clipNum,
+						const AutomationVisitor& visit);
 
 	mutable QReadWriteLock m_tracksMutex;
 
@@ -290,6 +290,9 @@ bool CompressorEffect::processAudioBuffer(sampleFrame* buf, const fpp_t frames)
 	const bool feedback = m_compressorControls.m_feedbackModel.value();
 	const bool lookahead = m_compressorControls.m_lookaheadModel.value();
 
+	// The lookahead delays the output by 20 ms, let the mixer compensate
+	setLatency(lookahead ? m_lookaheadDelayLength : 0);
+
 	for(fpp_t f = 0; f < frames; ++f)
 	{
 		sample_t drySignal[2] = {buf[f][0], buf[f][1]};
@@ -74,7 +74,8 @@ LadspaEffect::LadspaEffect( Model * _parent,
 	Effect( &ladspaeffect_plugin_descriptor, _parent, _key ),
 	m_controls( nullptr ),
 	m_maxSampleRate( 0 ),
-	m_key( LadspaSubPluginFeatures::subPluginKeyToLadspaKey( _key ) )
+	m_key( LadspaSubPluginFeatures::subPluginKeyToLadspaKey( _key ) ),
+	m_latencyPort( nullptr )
 {
 	Ladspa2LMMS * manager = Engine::getLADSPAManager();
 	if( manager->getDescription( m_key ) == nullptr )
@@ -261,6 +262,13 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 		sampleBack( _buf, o_buf, m_maxSampleRate );
 	}
 
+	if( m_latencyPort )
+	{
+		// reported at the plugin's rate, which may be below ours
+		setLatency( static_cast<f_cnt_t>( m_latencyPort->buffer[0] *
+			Engine::audioEngine()->processingSampleRate() / m_maxSampleRate ) );
+	}
+
 	checkGate( out_sum / frames );
 
 
@@ -367,6 +375,13 @@ void LadspaEffect::pluginInstantiation()
 				else
 				{
 					p->rate = CONTROL_RATE_OUTPUT;
+					// by convention, plugins report their latency
+					// through an output named "latency"
+					if( proc == 0 && p->name.compare( "latency",
+							Qt::CaseInsensitive ) == 0 )
+					{
+						m_latencyPort = p;
+					}
 				}
 			}
 
@@ -566,6 +581,7 @@ void LadspaEffect::pluginDestruction()
 	m_ports.clear();
 	m_handles.clear();
 	m_portControls.clear();
+	m_latencyPort = nullptr;
 }
 
 
@@ -88,6 +88,9 @@ private:
 	QVector<multi_proc_t> m_ports;
 	multi_proc_t m_portControls;
 
+	// control output by which the plugin reports its latency, if any
+	port_desc_t * m_latencyPort;
+
 } ;
 
 
@@ -168,6 +168,7 @@ void Lv2Instrument::play(sampleFrame *buf)
 
 	copyModelsToLmms();
 	copyBuffersToLmms(buf, fpp);
+	setLatency(reportedLatency());
 
 	instrumentTrack()->processAudioBuffer(buf, fpp, nullptr);
 }
@@ -385,6 +385,8 @@ void VestigeInstrument::loadFile( const QString & _file )
 		instrumentTrack()->setName( m_plugin->name() );
 	}
 
+	setLatency( m_plugin->latency() );
+
 	m_pluginMutex.unlock();
 
 	emit dataChanged();
@@ -475,6 +477,7 @@ void VestigeInstrument::closePlugin( void )
 	m_pluginMutex.lock();
 	delete m_plugin;
 	m_plugin = nullptr;
+	setLatency( 0 );
 	m_pluginMutex.unlock();
 }
 
@@ -678,7 +678,11 @@ bool RemoteVstPlugin::processMessage( const message & _m )
 			break;
 
 		case IdVstSetParameter:
-			m_plugin->setParameter( m_plugin, _m.getInt( 0 ), _m.getFloat( 1 ) );
+			// changes made during a period arrive together
+			for( int i = 0; i + 1 < _m.arguments(); i += 2 )
+			{
+				m_plugin->setParameter( m_plugin, _m.getInt( i ), _m.getFloat( i + 1 ) );
+			}
 			//sendMessage( IdVstSetParameter );
 			break;
 
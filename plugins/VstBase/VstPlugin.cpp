@@ -27,6 +27,7 @@
 #include "communication.h"
 
 #include <QtEndian>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
 #include <QDomElement>
@@ -623,8 +624,20 @@ void VstPlugin::savePreset()
 
 void VstPlugin::setParam( int i, float f )
 {
+	const message m = message( IdVstSetParameter ).addInt( i ).addFloat( f );
 	lock();
-	sendMessage( message( IdVstSetParameter ).addInt( i ).addFloat( f ) );
+	if( QThread::currentThread() == QCoreApplication::instance()->thread() )
+	{
+		// keep the order of changes queued by automation
+		sendQueuedMessages();
+		sendMessage( m );
+	}
+	else
+	{
+		// automation, send the latest value of each parameter together
+		// with the next period
+		queueValueMessage( m );
+	}
 	//waitForMessage( IdVstSetParameter, true );
 	unlock();
 }
@@ -144,6 +144,7 @@ void VstEffect::openPlugin( const QString & _plugin )
 
 	delete tf;
 
+	setLatency( m_plugin->latency() );
 	m_key.attributes["file"] = _plugin;
 }
 
@@ -469,6 +469,8 @@ void ZynAddSubFxInstrument::initPlugin()
 		m_plugin->setBufferSize( Engine::audioEngine()->framesPerPeriod() );
 	}
 
+	setLatency( m_remotePlugin ? m_remotePlugin->latency() : 0 );
+
 	m_pluginMutex.unlock();
 }
 
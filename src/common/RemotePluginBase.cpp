@@ -73,32 +73,22 @@ RemotePluginBase::~RemotePluginBase()
 
 int RemotePluginBase::sendMessage( const message & _m )
 {
+	// the arguments are sent as they are stored, see message
+	const int32_t header[2] = { _m.id, static_cast<int32_t>( _m.data.size() ) };
 #ifdef SYNC_WITH_SHM_FIFO
 	m_out->lock();
-	m_out->writeInt( _m.id );
-	m_out->writeInt( _m.data.size() );
-	int j = 8;
-	for( unsigned int i = 0; i < _m.data.size(); ++i )
-	{
-		m_out->writeString( _m.data[i] );
-		j += 4 + _m.data[i].size();
-	}
+	m_out->writeData( header, sizeof( header ) );
+	m_out->writeData( _m.data.data(), _m.data.size() );
 	m_out->unlock();
 	m_out->messageSent();
 #else
 	pthread_mutex_lock( &m_sendMutex );
-	writeInt( _m.id );
-	writeInt( _m.data.size() );
-	int j = 8;
-	for( unsigned int i = 0; i < _m.data.size(); ++i )
-	{
-		writeString( _m.data[i] );
-		j += 4 + _m.data[i].size();
-	}
+	write( header, sizeof( header ) );
+	write( _m.data.data(), _m.data.size() );
 	pthread_mutex_unlock( &m_sendMutex );
 #endif
 
-	return j;
+	return sizeof( header ) + _m.data.size();
 }
 
 
@@ -106,28 +96,24 @@ int RemotePluginBase::sendMessage( const message & _m )
 
 RemotePluginBase::message RemotePluginBase::receiveMessage()
 {
+	int32_t header[2];
+	message m;
 #ifdef SYNC_WITH_SHM_FIFO
 	m_in->waitForMessage();
 	m_in->lock();
-	message m;
-	m.id = m_in->readInt();
-	const int s = m_in->readInt();
-	for( int i = 0; i < s; ++i )
-	{
-		m.data.push_back( m_in->readString() );
-	}
+	m_in->readData( header, sizeof( header ) );
+	m.data.resize( std::max( header[1], 0 ) );
+	m_in->readData( &m.data[0], m.data.size() );
 	m_in->unlock();
 #else
 	pthread_mutex_lock( &m_receiveMutex );
-	message m;
-	m.id = readInt();
-	const int s = readInt();
-	for( int i = 0; i < s; ++i )
-	{
-		m.data.push_back( readString() );
-	}
+	read( header, sizeof( header ) );
+	m.data.resize( std::max( header[1], 0 ) );
+	read( &m.data[0], m.data.size() );
 	pthread_mutex_unlock( &m_receiveMutex );
 #endif
+	m.id = header[0];
+	m.indexArguments();
 	return m;
 }
 
@@ -37,6 +37,7 @@
 #include "ConfigManager.h"
 #include "SamplePlayHandle.h"
 #include "MemoryHelper.h"
+#include "MixHelpers.h"
 
 // platform-specific audio-interface-classes
 #include "AudioAlsa.h"
@@ -67,6 +68,9 @@ namespace lmms
 using LocklessListElement = LocklessList<PlayHandle*>::Element;
 
 static thread_local bool s_renderingThread;
+//! How often the current thread called requestChangeInModel() without
+//! doneChangeInModel() yet
+static thread_local int s_changesInModel = 0;
 
 
 
@@ -95,7 +99,11 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 #if (QT_VERSION < QT_VERSION_CHECK(5,14,0))
 	m_doChangesMutex( QMutex::Recursive ),
 #endif
-	m_waitingForWrite( false )
+	m_waitingForWrite( false ),
+	m_postedChanges( nullptr ),
+	m_appliedChanges( nullptr ),
+	m_postedCount( 0 ),
+	m_appliedCount( 0 )
 {
 	for( int i = 0; i < 2; ++i )
 	{
@@ -133,15 +141,22 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 		}
 	}
 
-	// allocte the FIFO from the determined size
-	m_fifo = new Fifo( fifoSize );
+	// allocte the FIFO from the determined size. Besides the periods
+	// waiting in it, the device reads one and the engine renders one.
+	m_fifo = new Fifo( fifoSize + 2, m_framesPerPeriod );
 
 	// now that framesPerPeriod is fixed initialize global BufferManager
 	BufferManager::init( m_framesPerPeriod );
 
-	int outputBufferSize = m_framesPerPeriod * sizeof(surroundSampleFrame);
-	m_outputBufferRead = static_cast<surroundSampleFrame *>(MemoryHelper::alignedMalloc(outputBufferSize));
-	m_outputBufferWrite = static_cast<surroundSampleFrame *>(MemoryHelper::alignedMalloc(outputBufferSize));
+	// allocate as many note play handles as the user expects to need, so
+	// playing doesn't have to wait for the pool to grow
+	NotePlayHandleManager::reserve(
+		ConfigManager::inst()->value( "audioengine", "noteplayhandles" ).toInt() );
+
+	// the output buffers come from the FIFO, so the engine can render right
+	// into the buffers the audio device reads
+	m_outputBufferRead = m_fifo->acquire();
+	m_outputBufferWrite = m_fifo->acquire();
 
 	BufferManager::clear(m_outputBufferRead, m_framesPerPeriod);
 	BufferManager::clear(m_outputBufferWrite, m_framesPerPeriod);
@@ -176,17 +191,14 @@ AudioEngine::~AudioEngine()
 		m_workers[w]->wait( 500 );
 	}
 
-	while( m_fifo->available() )
-	{
-		delete[] m_fifo->read();
-	}
 	delete m_fifo;
 
+	applyPostedChanges();
+	reclaimPostedChanges();
+
 	delete m_midiClient;
 	delete m_audioDev;
 
-	MemoryHelper::alignedFree(m_outputBufferRead);
-	MemoryHelper::alignedFree(m_outputBufferWrite);
 
 	for( int i = 0; i < 2; ++i )
 	{
@@ -220,6 +232,11 @@ void AudioEngine::startProcessing(bool needsFifo)
 {
 	if (needsFifo)
 	{
+		// from now on the last rendered period is passed to the device
+		// instead of being kept as m_outputBufferRead
+		m_fifo->release( m_outputBufferRead );
+		m_outputBufferRead = nullptr;
+
 		m_fifoWriter = new fifoWriter( this, m_fifo );
 		m_fifoWriter->start( QThread::HighPriority );
 	}
@@ -245,6 +262,11 @@ void AudioEngine::stopProcessing()
 		m_fifoWriter->finish();
 		m_fifoWriter->wait();
 		m_audioDev->stopProcessing();
+
+		// the device has given back all buffers, and the one the writer kept
+		// for the next period is ours again. It isn't passed through the
+		// fifo, which only takes one thread giving buffers back at a time.
+		m_outputBufferRead = m_fifoWriter->takeNextBuffer();
 		delete m_fifoWriter;
 		m_fifoWriter = nullptr;
 	}
@@ -339,6 +361,9 @@ const surroundSampleFrame * AudioEngine::renderNextBuffer()
 	m_profiler.startPeriod();
 
 	s_renderingThread = true;
+	AudioEngineWorkerThread::setRenderingThread( true );
+
+	applyPostedChanges();
 
 	if( m_clearSignal )
 	{
@@ -435,7 +460,9 @@ const surroundSampleFrame * AudioEngine::renderNextBuffer()
 	EnvelopeAndLfoParameters::instances()->trigger();
 	Controller::triggerFrameCounter();
 	AutomatableModel::incrementPeriodCounter();
+	BufferManager::finishPeriod();
 
+	AudioEngineWorkerThread::setRenderingThread( false );
 	s_renderingThread = false;
 
 	m_profiler.finishPeriod( processingSampleRate(), m_framesPerPeriod );
@@ -452,7 +479,17 @@ void AudioEngine::swapBuffers()
 	m_inputBufferRead = (m_inputBufferRead + 1) % 2;
 	m_inputBufferFrames[m_inputBufferWrite] = 0;
 
-	std::swap(m_outputBufferRead, m_outputBufferWrite);
+	if (m_fifoWriter)
+	{
+		// the last period goes to the audio device, which releases it
+		// once it is played
+		m_outputBufferRead = m_outputBufferWrite;
+		m_outputBufferWrite = m_fifoWriter->takeNextBuffer();
+	}
+	else
+	{
+		std::swap(m_outputBufferRead, m_outputBufferWrite);
+	}
 	BufferManager::clear(m_outputBufferWrite, m_framesPerPeriod);
 }
 
@@ -549,20 +586,7 @@ AudioEngine::StereoSample AudioEngine::getPeakValues(sampleFrame * ab, const f_c
 	sample_t peakLeft = 0.0f;
 	sample_t peakRight = 0.0f;
 
-	for (f_cnt_t f = 0; f < frames; ++f)
-	{
-		float const absLeft = qAbs(ab[f][0]);
-		float const absRight = qAbs(ab[f][1]);
-		if (absLeft > peakLeft)
-		{
-			peakLeft = absLeft;
-		}
-
-		if (absRight > peakRight)
-		{
-			peakRight = absRight;
-		}
-	}
+	MixHelpers::peak(ab, frames, peakLeft, peakRight);
 
 	return StereoSample(peakLeft, peakRight);
 }
@@ -659,6 +683,27 @@ void AudioEngine::restoreAudioDevice()
 
 
 
+void AudioEngine::addAudioPort(AudioPort * port)
+{
+	requestChangeInModel();
+	port->m_mixOrder = m_audioPorts.size();
+	m_audioPorts.push_back(port);
+	if (Engine::mixer())
+	{
+		// each port feeds one channel per period, so this is always enough
+		Engine::mixer()->reserveChannelInputs(m_audioPorts.size());
+	}
+	doneChangeInModel();
+
+	if (Engine::mixer())
+	{
+		Engine::mixer()->requestLatencyUpdate();
+	}
+}
+
+
+
+
 void AudioEngine::removeAudioPort(AudioPort * port)
 {
 	requestChangeInModel();
@@ -666,9 +711,19 @@ void AudioEngine::removeAudioPort(AudioPort * port)
 	QVector<AudioPort *>::Iterator it = std::find(m_audioPorts.begin(), m_audioPorts.end(), port);
 	if (it != m_audioPorts.end())
 	{
-		m_audioPorts.erase(it);
+		it = m_audioPorts.erase(it);
+		// keep the mix order of the remaining ports in sync with their position
+		for (; it != m_audioPorts.end(); ++it)
+		{
+			(*it)->m_mixOrder = it - m_audioPorts.begin();
+		}
 	}
 	doneChangeInModel();
+
+	if (Engine::mixer())
+	{
+		Engine::mixer()->requestLatencyUpdate();
+	}
 }
 
 
@@ -793,6 +848,7 @@ void AudioEngine::requestChangeInModel()
 		m_changesRequestCondition.wait( &m_waitChangesMutex );
 	}
 	m_waitChangesMutex.unlock();
+	++s_changesInModel;
 }
 
 
@@ -803,6 +859,7 @@ void AudioEngine::doneChangeInModel()
 	if( s_renderingThread )
 		return;
 
+	--s_changesInModel;
 	m_changesMutex.lock();
 	bool moreChanges = --m_changes;
 	m_changesMutex.unlock();
@@ -831,6 +888,138 @@ void AudioEngine::runChangesInModel()
 	}
 }
 
+
+
+
+void AudioEngine::postChangeInModel( std::function<void()> change )
+{
+	if( s_renderingThread )
+	{
+		change();
+		return;
+	}
+
+	reclaimPostedChanges();
+
+	PostedChange * c = new PostedChange{ std::move( change ), nullptr };
+	c->next = m_postedChanges.load( std::memory_order_relaxed );
+	while( !m_postedChanges.compare_exchange_weak( c->next, c,
+				std::memory_order_release, std::memory_order_relaxed ) )
+	{
+	}
+	m_postedCount.fetch_add( 1, std::memory_order_release );
+
+	if( !m_isProcessing || s_changesInModel > 0 )
+	{
+		// there's no audio thread which would apply it before the caller
+		// is done
+		applyPostedChangesNow();
+	}
+}
+
+
+
+
+void AudioEngine::waitForPostedChanges()
+{
+	if( s_renderingThread )
+	{
+		return;
+	}
+
+	if( !m_isProcessing || s_changesInModel > 0 )
+	{
+		// waiting for the audio thread would be in vain
+		applyPostedChangesNow();
+		return;
+	}
+
+	const unsigned posted = m_postedCount.load( std::memory_order_acquire );
+	const auto pending = [this, posted]() {
+		return static_cast<int>( posted - m_appliedCount.load( std::memory_order_acquire ) ) > 0;
+	};
+
+	// usually the audio thread gets to them within two periods
+	const int periodMicroseconds = static_cast<int>( 1000000.0f * m_framesPerPeriod
+						/ processingSampleRate() );
+	for( int waited = 0; m_isProcessing && pending() && waited < 2 * periodMicroseconds;
+		waited += periodMicroseconds / 4 + 1 )
+	{
+		QThread::usleep( periodMicroseconds / 4 + 1 );
+	}
+
+	if( pending() )
+	{
+		// the audio thread is stuck, e.g. waiting for the audio device
+		applyPostedChangesNow();
+	}
+}
+
+
+
+
+void AudioEngine::applyPostedChangesNow()
+{
+	// the audio thread doesn't render while the model is being changed, so
+	// the changes can be applied here. This thread may already hold that.
+	requestChangeInModel();
+	applyPostedChanges();
+	doneChangeInModel();
+}
+
+
+
+
+void AudioEngine::applyPostedChanges()
+{
+	PostedChange * c = m_postedChanges.exchange( nullptr, std::memory_order_acquire );
+	if( c == nullptr )
+	{
+		return;
+	}
+
+	// they were pushed in front of each other, so reverse them to apply
+	// them in the order they were posted
+	PostedChange * first = nullptr;
+	PostedChange * last = c;
+	unsigned count = 0;
+	while( c )
+	{
+		PostedChange * next = c->next;
+		c->next = first;
+		first = c;
+		c = next;
+		++count;
+	}
+
+	for( c = first; c; c = c->next )
+	{
+		c->apply();
+	}
+
+	// hand them over for deletion, which may free memory
+	last->next = m_appliedChanges.load( std::memory_order_relaxed );
+	while( !m_appliedChanges.compare_exchange_weak( last->next, first,
+				std::memory_order_release, std::memory_order_relaxed ) )
+	{
+	}
+	m_appliedCount.fetch_add( count, std::memory_order_release );
+}
+
+
+
+
+void AudioEngine::reclaimPostedChanges()
+{
+	PostedChange * c = m_appliedChanges.exchange( nullptr, std::memory_order_acquire );
+	while( c )
+	{
+		PostedChange * next = c->next;
+		delete c;
+		c = next;
+	}
+}
+
 bool AudioEngine::isAudioDevNameValid(QString name)
 {
 #ifdef LMMS_HAVE_SDL
@@ -1224,10 +1413,96 @@ MidiClient * AudioEngine::tryMidiClients()
 
 
 
+AudioEngine::Fifo::Fifo( int size, fpp_t frames ) :
+	m_free( size ),
+	m_written( size + 1 ),
+	m_freeCount( size ),
+	m_writtenCount( 0 ),
+	m_reading( nullptr )
+{
+	for( int i = 0; i < size; ++i )
+	{
+		m_buffers.push_back( static_cast<surroundSampleFrame *>(
+			MemoryHelper::alignedMalloc( frames * sizeof( surroundSampleFrame ) ) ) );
+		m_free.push( m_buffers.back() );
+	}
+}
+
+
+
+
+AudioEngine::Fifo::~Fifo()
+{
+	for( surroundSampleFrame * buffer : m_buffers )
+	{
+		MemoryHelper::alignedFree( buffer );
+	}
+}
+
+
+
+
+surroundSampleFrame * AudioEngine::Fifo::acquire()
+{
+	m_freeCount.acquire();
+	surroundSampleFrame * buffer = nullptr;
+	m_free.pop( buffer );
+	return buffer;
+}
+
+
+
+
+void AudioEngine::Fifo::release( surroundSampleFrame * buffer )
+{
+	m_free.push( buffer );
+	m_freeCount.release();
+}
+
+
+
+
+void AudioEngine::Fifo::write( surroundSampleFrame * buffer )
+{
+	m_written.push( buffer );
+	m_writtenCount.release();
+}
+
+
+
+
+surroundSampleFrame * AudioEngine::Fifo::read()
+{
+	if( m_reading )
+	{
+		release( m_reading );
+	}
+
+	m_writtenCount.acquire();
+	m_written.pop( m_reading );
+	return m_reading;
+}
+
+
+
+
+void AudioEngine::Fifo::waitUntilRead()
+{
+	// everything but the buffer the engine renders into and the one the
+	// writer keeps for the next period has to be free
+	const int buffers = static_cast<int>( m_buffers.size() ) - 2;
+	m_freeCount.acquire( buffers );
+	m_freeCount.release( buffers );
+}
+
+
+
+
 AudioEngine::fifoWriter::fifoWriter( AudioEngine* audioEngine, Fifo * fifo ) :
 	m_audioEngine( audioEngine ),
 	m_fifo( fifo ),
-	m_writing( true )
+	m_writing( true ),
+	m_nextBuffer( nullptr )
 {
 	setObjectName("AudioEngine::fifoWriter");
 }
@@ -1243,6 +1518,16 @@ void AudioEngine::fifoWriter::finish()
 
 
 
+surroundSampleFrame * AudioEngine::fifoWriter::takeNextBuffer()
+{
+	surroundSampleFrame * buffer = m_nextBuffer;
+	m_nextBuffer = nullptr;
+	return buffer;
+}
+
+
+
+
 void AudioEngine::fifoWriter::run()
 {
 	disable_denormals();
@@ -1258,16 +1543,15 @@ void AudioEngine::fifoWriter::run()
 #endif
 #endif
 
-	const fpp_t frames = m_audioEngine->framesPerPeriod();
+	m_nextBuffer = m_fifo->acquire();
 	while( m_writing )
 	{
-		surroundSampleFrame * buffer = new surroundSampleFrame[frames];
-		const surroundSampleFrame * b = m_audioEngine->renderNextBuffer();
-		memcpy( buffer, b, frames * sizeof( surroundSampleFrame ) );
-		write( buffer );
+		// the period rendered before is passed on as it is, see swapBuffers()
+		m_audioEngine->renderNextBuffer();
+		write( m_audioEngine->m_outputBufferRead );
 	}
-
-	// Let audio backend stop processing
+	// Let audio backend stop processing. m_nextBuffer is kept, since the
+	// device gives back buffers from its own thread in the meantime.
 	write( nullptr );
 	m_fifo->waitUntilRead();
 }
@@ -1283,6 +1567,12 @@ void AudioEngine::fifoWriter::write( surroundSampleFrame * buffer )
 	m_audioEngine->runChangesInModel();
 
 	m_fifo->write( buffer );
+	if( buffer )
+	{
+		// wait for the device to play a period while other threads may
+		// still change the model
+		m_nextBuffer = m_fifo->acquire();
+	}
 
 	m_audioEngine->m_doChangesMutex.lock();
 	m_audioEngine->m_waitingForWrite = false;
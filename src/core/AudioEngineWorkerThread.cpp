@@ -44,10 +44,124 @@ AudioEngineWorkerThread::JobQueue AudioEngineWorkerThread::globalJobQueue;
 QWaitCondition * AudioEngineWorkerThread::queueReadyWaitCond = nullptr;
 QList<AudioEngineWorkerThread *> AudioEngineWorkerThread::workerThreads;
 
+// index of the calling thread's deque in the job queue - the rendering thread
+// owns the main deque in slot 0, all other threads which are not registered
+// don't own a deque and can only steal
+static constexpr int NoDeque = -1;
+static thread_local int s_dequeIndex = NoDeque;
+
+
+static inline void spinPause()
+{
+#ifdef __SSE__
+	_mm_pause();
+#endif
+}
+
+
+
+
+// implementation of the per-thread work-stealing deque
+AudioEngineWorkerThread::JobQueue::Deque::Deque() :
+	m_top( 0 ),
+	m_bottom( 0 )
+{
+	std::fill(m_items, m_items + JOB_QUEUE_SIZE, nullptr);
+}
+
+
+
+
+bool AudioEngineWorkerThread::JobQueue::Deque::push( ThreadableJob * _job )
+{
+	const auto b = m_bottom.load( std::memory_order_relaxed );
+	const auto t = m_top.load( std::memory_order_acquire );
+	if( b - t >= static_cast<std::int64_t>( JOB_QUEUE_SIZE ) )
+	{
+		return false;
+	}
+	m_items[b & MASK].store( _job, std::memory_order_relaxed );
+	std::atomic_thread_fence( std::memory_order_release );
+	m_bottom.store( b + 1, std::memory_order_relaxed );
+	return true;
+}
+
+
+
+
+ThreadableJob * AudioEngineWorkerThread::JobQueue::Deque::pop()
+{
+	const auto b = m_bottom.load( std::memory_order_relaxed ) - 1;
+	m_bottom.store( b, std::memory_order_relaxed );
+	std::atomic_thread_fence( std::memory_order_seq_cst );
+	auto t = m_top.load( std::memory_order_relaxed );
+
+	ThreadableJob * job = nullptr;
+	if( t <= b )
+	{
+		job = m_items[b & MASK].load( std::memory_order_relaxed );
+		if( t == b )
+		{
+			// last item - race against stealing threads
+			if( !m_top.compare_exchange_strong( t, t + 1,
+					std::memory_order_seq_cst, std::memory_order_relaxed ) )
+			{
+				job = nullptr;
+			}
+			m_bottom.store( b + 1, std::memory_order_relaxed );
+		}
+	}
+	else
+	{
+		m_bottom.store( b + 1, std::memory_order_relaxed );
+	}
+	return job;
+}
+
+
+
+
+ThreadableJob * AudioEngineWorkerThread::JobQueue::Deque::steal()
+{
+	auto t = m_top.load( std::memory_order_acquire );
+	std::atomic_thread_fence( std::memory_order_seq_cst );
+	const auto b = m_bottom.load( std::memory_order_acquire );
+
+	if( t < b )
+	{
+		ThreadableJob * job = m_items[t & MASK].load( std::memory_order_relaxed );
+		if( m_top.compare_exchange_strong( t, t + 1,
+				std::memory_order_seq_cst, std::memory_order_relaxed ) )
+		{
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+
+
+
 // implementation of internal JobQueue
+AudioEngineWorkerThread::JobQueue::JobQueue() :
+	m_mainDeque(),
+	m_numDeques( 1 ),
+	m_itemsQueued( 0 ),
+	m_itemsDone( 0 ),
+	m_pushCount( 0 ),
+	m_opMode( Static ),
+	m_parkedThreads( 0 )
+{
+	std::fill(m_deques, m_deques + MAX_THREADS, nullptr);
+	m_deques[0] = &m_mainDeque;
+}
+
+
+
+
 void AudioEngineWorkerThread::JobQueue::reset( OperationMode _opMode )
 {
-	m_writeIndex = 0;
+	m_itemsQueued = 0;
 	m_itemsDone = 0;
 	m_opMode = _opMode;
 }
@@ -61,61 +175,226 @@ void AudioEngineWorkerThread::JobQueue::addJob( ThreadableJob * _job )
 	{
 		// update job state
 		_job->queue();
-		// actually queue the job via atomic operations
-		auto index = m_writeIndex++;
-		if (index < JOB_QUEUE_SIZE) {
-			m_items[index] = _job;
-		} else {
-			qWarning() << "Job queue is full!";
-			++m_itemsDone;
+		// account for the job before it becomes visible to other threads
+		++m_itemsQueued;
+		if( s_dequeIndex != NoDeque &&
+			m_deques[s_dequeIndex].load()->push( _job ) )
+		{
+			++m_pushCount;
+			if( m_parkedThreads > 0 )
+			{
+				wakeParkedThreads();
+			}
+		}
+		else
+		{
+			// our deque is full or we don't have one - don't drop the job
+			// but process it right away
+			_job->process();
+			jobDone();
 		}
 	}
 }
 
 
 
+
 void AudioEngineWorkerThread::JobQueue::run()
 {
-	bool processedJob = true;
-	while (processedJob && m_itemsDone < m_writeIndex)
+	// in static mode no new jobs can show up once all deques are empty, so
+	// there's no point in sticking around - the caller waits for the jobs
+	// still in progress
+	processJobs( m_opMode == Dynamic );
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::wait()
+{
+	// help out with whatever is left instead of just spinning
+	processJobs( true );
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::waitFor( ThreadableJob * _job )
+{
+	// the job may still be in our own deque, or another thread is on it
+	while( _job->state() == ThreadableJob::ProcessingState::Queued ||
+		_job->state() == ThreadableJob::ProcessingState::InProgress )
 	{
-		processedJob = false;
-		for( int i = 0; i < m_writeIndex && i < JOB_QUEUE_SIZE; ++i )
+		ThreadableJob * job = findJob();
+		if( job )
+		{
+			job->process();
+			jobDone();
+		}
+		else
 		{
-			ThreadableJob * job = m_items[i].exchange(nullptr);
-			if( job )
+			spinPause();
+		}
+	}
+}
+
+
+
+
+bool AudioEngineWorkerThread::JobQueue::registerThread( Deque * _deque )
+{
+	// take the first free slot, so slots of threads which are gone get reused
+	for( int index = 1; index < MAX_THREADS; ++index )
+	{
+		Deque * expected = nullptr;
+		if( m_deques[index].compare_exchange_strong( expected, _deque ) )
+		{
+			int numDeques = m_numDeques;
+			while( numDeques <= index &&
+				!m_numDeques.compare_exchange_weak( numDeques, index + 1 ) )
 			{
-				job->process();
-				processedJob = true;
-				++m_itemsDone;
 			}
+			s_dequeIndex = index;
+			return true;
 		}
-		// always exit loop if we're not in dynamic mode
-		processedJob = processedJob && ( m_opMode == Dynamic );
 	}
+	return false;
 }
 
 
 
 
-void AudioEngineWorkerThread::JobQueue::wait()
+void AudioEngineWorkerThread::JobQueue::unregisterThread()
 {
-	while (m_itemsDone < m_writeIndex)
+	if( s_dequeIndex > 0 )
 	{
-#ifdef __SSE__
-		_mm_pause();
-#endif
+		m_deques[s_dequeIndex] = nullptr;
+		s_dequeIndex = NoDeque;
+	}
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::setRenderingThread( bool _rendering )
+{
+	// a worker never renders, so it can't lose its own deque here
+	Q_ASSERT( s_dequeIndex <= 0 );
+	s_dequeIndex = _rendering ? 0 : NoDeque;
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::processJobs( bool _untilDone )
+{
+	int idleSpins = 0;
+	while( m_itemsDone < m_itemsQueued )
+	{
+		// remember how many jobs have been pushed so far so we do not park
+		// if new jobs show up while we're looking for work
+		const int seenPushes = m_pushCount;
+		ThreadableJob * job = findJob();
+		if( job )
+		{
+			job->process();
+			jobDone();
+			idleSpins = 0;
+		}
+		else if( !_untilDone )
+		{
+			return;
+		}
+		else if( ++idleSpins < MAX_IDLE_SPINS )
+		{
+			spinPause();
+		}
+		else
+		{
+			park( seenPushes );
+			idleSpins = 0;
+		}
+	}
+}
+
+
+
+
+ThreadableJob * AudioEngineWorkerThread::JobQueue::findJob()
+{
+	const int self = s_dequeIndex;
+	ThreadableJob * job = nullptr;
+	if( self != NoDeque )
+	{
+		job = m_deques[self].load()->pop();
+		if( job )
+		{
+			return job;
+		}
+	}
+
+	// our own deque is empty, so try to steal from the others, starting
+	// with our neighbour so not all threads hammer the same victim - threads
+	// without a deque steal from all of them
+	const int numDeques = m_numDeques;
+	const int first = self != NoDeque ? self : 0;
+	for( int i = self != NoDeque ? 1 : 0; i < numDeques; ++i )
+	{
+		Deque * victim = m_deques[( first + i ) % numDeques];
+		if( victim && ( job = victim->steal() ) )
+		{
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::jobDone()
+{
+	if( ++m_itemsDone >= m_itemsQueued && m_parkedThreads > 0 )
+	{
+		wakeParkedThreads();
 	}
 }
 
 
 
 
+void AudioEngineWorkerThread::JobQueue::park( int _seenPushes )
+{
+	m_parkMutex.lock();
+	++m_parkedThreads;
+	// re-check after announcing ourselves so wake-ups can't get lost
+	while( m_itemsDone < m_itemsQueued && m_pushCount == _seenPushes )
+	{
+		m_parkCond.wait( &m_parkMutex );
+	}
+	--m_parkedThreads;
+	m_parkMutex.unlock();
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::wakeParkedThreads()
+{
+	m_parkMutex.lock();
+	m_parkCond.wakeAll();
+	m_parkMutex.unlock();
+}
+
+
+
+
 
 // implementation of worker threads
 
 AudioEngineWorkerThread::AudioEngineWorkerThread( AudioEngine* audioEngine ) :
 	QThread( audioEngine ),
+	m_deque(),
 	m_quit( false )
 {
 	// initialize global static data
@@ -170,6 +449,12 @@ void AudioEngineWorkerThread::run()
 	MemoryManager::ThreadGuard mmThreadGuard; Q_UNUSED(mmThreadGuard);
 	disable_denormals();
 
+	if( !globalJobQueue.registerThread( &m_deque ) )
+	{
+		qWarning() << "Too many worker threads, not taking part in processing";
+		return;
+	}
+
 	QMutex m;
 	while( m_quit == false )
 	{
@@ -178,6 +463,8 @@ void AudioEngineWorkerThread::run()
 		globalJobQueue.run();
 		m.unlock();
 	}
+
+	globalJobQueue.unregisterThread();
 }
 
 } // namespace lmms
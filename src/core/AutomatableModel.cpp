@@ -24,6 +24,8 @@
 
 #include "AutomatableModel.h"
 
+#include <algorithm>
+
 #include "lmms_math.h"
 
 #include "AudioEngine.h"
@@ -57,6 +59,10 @@ AutomatableModel::AutomatableModel(
 	m_valueBuffer( static_cast<int>( Engine::audioEngine()->framesPerPeriod() ) ),
 	m_lastUpdatedPeriod( -1 ),
 	m_hasSampleExactData(false),
+	m_automationSpanCount( 0 ),
+	m_automationPeriod( -1 ),
+	m_automationTicksPerFrame( 0 ),
+	m_automationCursor( 0 ),
 	m_useControllerValue(true)
 
 {
@@ -406,6 +412,49 @@ void AutomatableModel::setAutomatedValue( const float value )
 
 
 
+void AutomatableModel::setAutomationCurve( const AutomationCurve * curve, float tick, float endTick,
+				f_cnt_t offset, float ticksPerFrame )
+{
+	QMutexLocker m( &m_valueBufferMutex );
+
+	if( m_automationPeriod != s_periodCounter )
+	{
+		m_automationPeriod = s_periodCounter;
+		m_automationSpanCount = 0;
+	}
+	m_automationTicksPerFrame = ticksPerFrame;
+
+	if( m_automationSpanCount > 0 )
+	{
+		AutomationSpan & last = m_automationSpans[m_automationSpanCount - 1];
+		const float lastTick = std::min( last.tick + ( offset - last.offset ) * ticksPerFrame,
+							last.endTick );
+		// ticks start at whole frames, so the last span may be up to a
+		// frame off, which doesn't make it a jump
+		if( last.curve == curve && last.endTick == endTick
+			&& std::abs( lastTick - std::min( tick, endTick ) ) <= ticksPerFrame )
+		{
+			return;
+		}
+		if( last.offset == offset )
+		{
+			// e.g. a later clip took over at the same frame
+			last = { curve, offset, tick, endTick };
+			return;
+		}
+	}
+
+	// more jumps than that within one period are unlikely, and the last
+	// span then just continues until the next period
+	if( m_automationSpanCount < MaxAutomationSpans )
+	{
+		m_automationSpans[m_automationSpanCount++] = { curve, offset, tick, endTick };
+	}
+}
+
+
+
+
 void AutomatableModel::setRange( const float min, const float max,
 							const float step )
 {
@@ -668,6 +717,43 @@ ValueBuffer * AutomatableModel::valueBuffer()
 		}
 	}
 
+	if (m_automationPeriod == s_periodCounter && !m_useControllerValue)
+	{
+		// sample exact automation, which is only worth passing on if the
+		// value changes within this period. Frames before the first span
+		// keep the value the model had before it was automated.
+		float * nvalues = m_valueBuffer.values();
+		const int frames = m_valueBuffer.length();
+		int frame = 0;
+		for (int i = 0; i <= m_automationSpanCount; i++)
+		{
+			const int end = i < m_automationSpanCount
+				? std::clamp(static_cast<int>(m_automationSpans[i].offset), frame, frames) : frames;
+			const AutomationSpan* span = i > 0 ? &m_automationSpans[i - 1] : nullptr;
+			if (span && span->curve)
+			{
+				const float tick = span->tick + (frame - span->offset) * m_automationTicksPerFrame;
+				span->curve->valuesAt(tick, m_automationTicksPerFrame, span->endTick,
+						nvalues + frame, end - frame, m_automationCursor);
+				for (int f = frame; f < end; f++)
+				{
+					nvalues[f] = fittedValue(scaledValue(nvalues[f]));
+				}
+			}
+			else
+			{
+				std::fill(nvalues + frame, nvalues + end, span ? val : m_oldValue);
+			}
+			frame = end;
+		}
+		const bool constant = std::all_of(nvalues, nvalues + frames,
+						[nvalues](float v) { return v == nvalues[0]; });
+		m_oldValue = val;
+		m_lastUpdatedPeriod = s_periodCounter;
+		m_hasSampleExactData = !constant;
+		return constant ? nullptr : &m_valueBuffer;
+	}
+
 	if( m_oldValue != val )
 	{
 		m_valueBuffer.interpolate( m_oldValue, val );
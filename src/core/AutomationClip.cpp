@@ -26,6 +26,7 @@
 
 #include "AutomationClip.h"
 
+#include "AudioEngine.h"
 #include "AutomationNode.h"
 #include "AutomationClipView.h"
 #include "AutomationTrack.h"
@@ -36,6 +37,7 @@
 #include "Song.h"
 
 #include <cmath>
+#include <utility>
 
 namespace lmms
 {
@@ -52,6 +54,9 @@ AutomationClip::AutomationClip( AutomationTrack * _auto_track ) :
 #endif
 	m_autoTrack( _auto_track ),
 	m_objects(),
+	m_curve( std::make_shared<AutomationCurve>() ),
+	m_playbackCurve( m_curve.get() ),
+	m_curveCursor( 0 ),
 	m_tension( 1.0 ),
 	m_progressionType( DiscreteProgression ),
 	m_dragging( false ),
@@ -86,6 +91,9 @@ AutomationClip::AutomationClip( const AutomationClip & _clip_to_copy ) :
 #endif
 	m_autoTrack( _clip_to_copy.m_autoTrack ),
 	m_objects( _clip_to_copy.m_objects ),
+	m_curve( std::make_shared<AutomationCurve>() ),
+	m_playbackCurve( m_curve.get() ),
+	m_curveCursor( 0 ),
 	m_tension( _clip_to_copy.m_tension ),
 	m_progressionType( _clip_to_copy.m_progressionType )
 {
@@ -101,6 +109,8 @@ AutomationClip::AutomationClip( const AutomationClip & _clip_to_copy ) :
 		// Sets the node's clip to this one
 		m_timeMap[POS(it)].setClip(this);
 	}
+	updateCurve();
+
 	if (!getTrack()){ return; }
 	switch( getTrack()->trackContainer()->type() )
 	{
@@ -116,6 +126,19 @@ AutomationClip::AutomationClip( const AutomationClip & _clip_to_copy ) :
 	}
 }
 
+AutomationClip::~AutomationClip()
+{
+	// updateCurve() may have left a change for the audio thread which
+	// refers to this clip
+	if( Engine::audioEngine() )
+	{
+		Engine::audioEngine()->waitForPostedChanges();
+	}
+}
+
+
+
+
 bool AutomationClip::addObject( AutomatableModel * _obj, bool _search_dup )
 {
 	QMutexLocker m(&m_clipMutex);
@@ -156,6 +179,7 @@ void AutomationClip::setProgressionType(
 		_new_progression_type == CubicHermiteProgression )
 	{
 		m_progressionType = _new_progression_type;
+		updateCurve();
 		emit dataChanged();
 	}
 }
@@ -173,6 +197,7 @@ void AutomationClip::setTension( QString _new_tension )
 	if( ok && nt > -0.01 && nt < 1.01 )
 	{
 		m_tension = nt;
+		updateCurve();
 	}
 }
 
@@ -599,6 +624,16 @@ float AutomationClip::valueAt( timeMap::const_iterator v, int offset ) const
 
 
 
+float AutomationClip::curveValueAt( float ticks ) const
+{
+	QMutexLocker m(&m_clipMutex);
+
+	return m_curve->valueAt( ticks, m_curveCursor );
+}
+
+
+
+
 float *AutomationClip::valuesAfter( const TimePos & _time ) const
 {
 	QMutexLocker m(&m_clipMutex);
@@ -1063,6 +1098,7 @@ void AutomationClip::clear()
 	QMutexLocker m(&m_clipMutex);
 
 	m_timeMap.clear();
+	updateCurve();
 
 	emit dataChanged();
 }
@@ -1138,6 +1174,7 @@ void AutomationClip::generateTangents(timeMap::iterator it, int numToGenerate)
 	{
 		it.value().setInTangent(0);
 		it.value().setOutTangent(0);
+		updateCurve();
 		return;
 	}
 
@@ -1157,7 +1194,7 @@ void AutomationClip::generateTangents(timeMap::iterator it, int numToGenerate)
 			// of the last node
 			it.value().setInTangent(0);
 			it.value().setOutTangent(0);
-			return;
+			break;
 		}
 		else
 		{
@@ -1189,6 +1226,85 @@ void AutomationClip::generateTangents(timeMap::iterator it, int numToGenerate)
 		}
 		it++;
 	}
+
+	updateCurve();
+}
+
+
+
+
+// Compile the nodes into an AutomationCurve. The segments follow the
+// formulas of valueAt().
+std::shared_ptr<const AutomationCurve> AutomationClip::compileCurve() const
+{
+	QMutexLocker m(&m_clipMutex);
+
+	if( m_timeMap.isEmpty() )
+	{
+		return std::make_shared<AutomationCurve>();
+	}
+
+	std::vector<AutomationCurve::Segment> segments;
+	segments.reserve( m_timeMap.size() - 1 );
+	for( timeMap::const_iterator it = m_timeMap.begin(); it + 1 != m_timeMap.end(); ++it )
+	{
+		const auto next = it + 1;
+		const int length = POS(next) - POS(it);
+
+		AutomationCurve::Segment s;
+		s.start = POS(it);
+		s.end = POS(next);
+		s.inValue = INVAL(it);
+		s.invLength = 1.0f / length;
+		s.a0 = OUTVAL(it);
+		s.a1 = s.a2 = s.a3 = 0;
+
+		if( m_progressionType == LinearProgression )
+		{
+			s.a1 = INVAL(next) - OUTVAL(it);
+		}
+		else if( m_progressionType == CubicHermiteProgression )
+		{
+			// the Hermite basis functions multiplied out
+			const float m1 = OUTTAN(it) * length * m_tension;
+			const float m2 = INTAN(next) * length * m_tension;
+			s.a1 = m1;
+			s.a2 = -3 * OUTVAL(it) - 2 * m1 + 3 * INVAL(next) - m2;
+			s.a3 = 2 * OUTVAL(it) + m1 - 2 * INVAL(next) + m2;
+		}
+		segments.push_back( s );
+	}
+
+	const timeMap::const_iterator last = m_timeMap.end() - 1;
+	return std::make_shared<AutomationCurve>( std::move( segments ), POS(last),
+							INVAL(last), OUTVAL(last) );
+}
+
+
+
+
+// Publish the compiled nodes for curve() and the audio thread
+void AutomationClip::updateCurve()
+{
+	const std::shared_ptr<const AutomationCurve> curve = compileCurve();
+	std::shared_ptr<const AutomationCurve> oldCurve;
+	{
+		QMutexLocker m(&m_clipMutex);
+		oldCurve = std::exchange( m_curve, curve );
+	}
+
+	if( Engine::audioEngine() == nullptr )
+	{
+		m_playbackCurve = curve.get();
+		return;
+	}
+
+	// the audio thread switches over before its next period, and the old
+	// curve is released with the change, which doesn't happen on the audio
+	// thread
+	Engine::audioEngine()->postChangeInModel( [this, curve, oldCurve]() {
+		m_playbackCurve = curve.get();
+	} );
 }
 
 } // namespace lmms
\ No newline at end of file
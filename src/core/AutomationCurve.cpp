@@ -0,0 +1,122 @@
+/*
+ * AutomationCurve.cpp - the nodes of an AutomationClip, compiled for playback
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AutomationCurve.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace lmms
+{
+
+
+AutomationCurve::AutomationCurve() :
+	m_lastPosition( 0 ),
+	m_lastInValue( 0 ),
+	m_lastOutValue( 0 ),
+	m_empty( true )
+{
+}
+
+
+
+
+AutomationCurve::AutomationCurve( std::vector<Segment> segments, int lastPosition,
+					float lastInValue, float lastOutValue ) :
+	m_segments( std::move( segments ) ),
+	m_lastPosition( lastPosition ),
+	m_lastInValue( lastInValue ),
+	m_lastOutValue( lastOutValue ),
+	m_empty( false )
+{
+}
+
+
+
+
+float AutomationCurve::valueAt( float tick, int & cursor ) const
+{
+	if( m_empty )
+	{
+		return 0;
+	}
+
+	// the same rules as AutomationClip::valueAt(): nothing before the first
+	// node, the inValue exactly at a node and the outValue after the last
+	if( tick >= m_lastPosition )
+	{
+		return tick == m_lastPosition ? m_lastInValue : m_lastOutValue;
+	}
+	if( m_segments.empty() || tick < m_segments.front().start )
+	{
+		return 0;
+	}
+
+	cursor = findSegment( tick, cursor );
+	const Segment & s = m_segments[cursor];
+	const float offset = tick - s.start;
+	if( offset == 0 )
+	{
+		return s.inValue;
+	}
+
+	const float t = offset * s.invLength;
+	return s.a0 + t * ( s.a1 + t * ( s.a2 + t * s.a3 ) );
+}
+
+
+
+
+void AutomationCurve::valuesAt( float tick, float step, float endTick,
+				float * values, int count, int & cursor ) const
+{
+	for( int i = 0; i < count; ++i )
+	{
+		values[i] = valueAt( std::min( tick + i * step, endTick ), cursor );
+	}
+}
+
+
+
+
+int AutomationCurve::findSegment( float tick, int cursor ) const
+{
+	// playback mostly stays in the same segment or moves on to the next one
+	const int size = static_cast<int>( m_segments.size() );
+	for( int i = cursor; i >= 0 && i < size && i <= cursor + 1; ++i )
+	{
+		if( m_segments[i].start <= tick && tick < m_segments[i].end )
+		{
+			return i;
+		}
+	}
+
+	// first segment which starts after tick, the one before contains it
+	const auto it = std::upper_bound( m_segments.begin(), m_segments.end(), tick,
+		[]( float t, const Segment & s ) { return t < s.start; } );
+	return static_cast<int>( it - m_segments.begin() ) - 1;
+}
+
+
+} // namespace lmms
@@ -26,7 +26,9 @@
 
 #include "BufferManager.h"
 
+#include <atomic>
 #include <cstring>
+#include <vector>
 
 #include "MemoryManager.h"
 
@@ -35,6 +37,43 @@ namespace lmms
 
 fpp_t BufferManager::s_framesPerPeriod;
 
+
+namespace
+{
+
+// number of period buffers allocated at once
+constexpr int BuffersPerSlab = 16;
+
+std::atomic<unsigned> s_period(0);
+
+struct PeriodArena
+{
+	std::vector<sampleFrame *> slabs;
+	fpp_t framesPerPeriod = 0;
+	int used = 0;
+	unsigned period = 0;
+
+	~PeriodArena()
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		for( sampleFrame * slab : slabs )
+		{
+			MM_FREE( slab );
+		}
+		slabs.clear();
+		used = 0;
+	}
+} ;
+
+thread_local PeriodArena t_arena;
+
+} // namespace
+
+
 void BufferManager::init( fpp_t fpp )
 {
 	s_framesPerPeriod = fpp;
@@ -65,4 +104,40 @@ void BufferManager::release( sampleFrame * buf )
 	MM_FREE( buf );
 }
 
+
+sampleFrame * BufferManager::acquireForPeriod()
+{
+	PeriodArena & arena = t_arena;
+	if( arena.framesPerPeriod != s_framesPerPeriod )
+	{
+		arena.clear();
+		arena.framesPerPeriod = s_framesPerPeriod;
+	}
+
+	// everything handed out in earlier periods is free again
+	const unsigned period = s_period.load( std::memory_order_relaxed );
+	if( arena.period != period )
+	{
+		arena.period = period;
+		arena.used = 0;
+	}
+
+	const int slab = arena.used / BuffersPerSlab;
+	if( slab == static_cast<int>( arena.slabs.size() ) )
+	{
+		// only happens when more handles play than ever before
+		arena.slabs.push_back( MM_ALLOC<sampleFrame>( BuffersPerSlab * s_framesPerPeriod ) );
+	}
+
+	return arena.slabs[slab] + ( arena.used++ % BuffersPerSlab ) * s_framesPerPeriod;
+}
+
+
+void BufferManager::finishPeriod()
+{
+	// the arenas notice this when they are used the next time, so the
+	// threads don't have to be known here
+	s_period.fetch_add( 1, std::memory_order_relaxed );
+}
+
 } // namespace lmms
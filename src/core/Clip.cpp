@@ -97,6 +97,10 @@ void Clip::movePosition( const TimePos & pos )
 	{
 		Engine::audioEngine()->requestChangeInModel();
 		m_startPosition = newPos;
+		if( getTrack() )
+		{
+			getTrack()->clipPositionChanged();
+		}
 		Engine::audioEngine()->doneChangeInModel();
 		Engine::getSong()->updateLength();
 		emit positionChanged();
@@ -116,6 +120,10 @@ void Clip::movePosition( const TimePos & pos )
 void Clip::changeLength( const TimePos & length )
 {
 	m_length = length;
+	if( getTrack() )
+	{
+		getTrack()->clipPositionChanged();
+	}
 	Engine::getSong()->updateLength();
 	emit lengthChanged();
 }
@@ -0,0 +1,127 @@
+/*
+ * ClipIndex.cpp - finds the clips of a track within a time range
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ClipIndex.h"
+
+#include <algorithm>
+
+#include "Clip.h"
+
+namespace lmms
+{
+
+
+ClipIndex::ClipIndex( const QVector<Clip *> & clips )
+{
+	m_entries.reserve( clips.size() );
+	for( Clip * clip : clips )
+	{
+		m_entries.push_back( { clip, clip->startPosition(), clip->endPosition(), 0 } );
+	}
+
+	// stable, so clips starting at the same time keep the order of the track
+	std::stable_sort( m_entries.begin(), m_entries.end(),
+		[]( const Entry & a, const Entry & b ) { return a.start < b.start; } );
+
+	build( 0, static_cast<int>( m_entries.size() ) );
+}
+
+
+
+
+void ClipIndex::clipsInRange( QVector<Clip *> & result, tick_t start, tick_t end ) const
+{
+	const int found = result.size();
+	query( 0, static_cast<int>( m_entries.size() ), start, end, result );
+
+	// the query finds the clips in order, so they only have to be merged
+	// with what the caller collected before, which std::inplace_merge()
+	// might allocate a buffer for
+	if( found > 0 )
+	{
+		for( int i = found; i < result.size(); ++i )
+		{
+			Clip * clip = result[i];
+			const auto pos = std::upper_bound( result.begin(), result.begin() + i, clip,
+								Clip::comparePosition );
+			std::move_backward( pos, result.begin() + i, result.begin() + i + 1 );
+			*pos = clip;
+		}
+	}
+}
+
+
+
+
+tick_t ClipIndex::build( int begin, int end )
+{
+	if( begin >= end )
+	{
+		return -1;
+	}
+
+	// the middle of a range is the root of its subtree
+	const int mid = begin + ( end - begin ) / 2;
+	Entry & e = m_entries[mid];
+	e.maxEnd = std::max( { e.end, build( begin, mid ), build( mid + 1, end ) } );
+	return e.maxEnd;
+}
+
+
+
+
+void ClipIndex::query( int begin, int end, tick_t start, tick_t stop,
+						QVector<Clip *> & result ) const
+{
+	if( begin >= end )
+	{
+		return;
+	}
+
+	const int mid = begin + ( end - begin ) / 2;
+	const Entry & e = m_entries[mid];
+	if( e.maxEnd < start )
+	{
+		// everything in here ends before the range
+		return;
+	}
+
+	query( begin, mid, start, stop, result );
+
+	if( e.start > stop )
+	{
+		// this clip and the ones after it start after the range
+		return;
+	}
+
+	if( e.end >= start )
+	{
+		result.push_back( e.clip );
+	}
+
+	query( mid + 1, end, start, stop, result );
+}
+
+
+} // namespace lmms
@@ -0,0 +1,94 @@
+/*
+ * CompensationDelay.cpp - delay line for plugin delay compensation
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "CompensationDelay.h"
+
+#include <algorithm>
+
+namespace lmms
+{
+
+
+CompensationDelay::CompensationDelay() :
+	m_buffer(),
+	m_capacity( 0 ),
+	m_delay( 0 ),
+	m_position( 0 ),
+	m_tail( 0 )
+{
+}
+
+
+
+
+void CompensationDelay::setDelay( f_cnt_t frames )
+{
+	frames = std::max<f_cnt_t>( frames, 0 );
+	if( frames == m_delay )
+	{
+		return;
+	}
+
+	if( frames > m_capacity )
+	{
+		m_buffer.reset( new sampleFrame[frames] );
+		m_capacity = frames;
+	}
+	std::fill_n( m_buffer.get(), m_capacity, sampleFrame{} );
+
+	m_delay = frames;
+	m_position = 0;
+	m_tail = 0;
+}
+
+
+
+
+void CompensationDelay::process( sampleFrame * buf, fpp_t frames, bool active )
+{
+	if( m_delay == 0 )
+	{
+		return;
+	}
+
+	// the ring holds exactly m_delay frames, so swapping the incoming frames
+	// with the ring contents yields the input from m_delay frames ago
+	f_cnt_t done = 0;
+	while( done < frames )
+	{
+		const f_cnt_t chunk = std::min<f_cnt_t>( frames - done, m_delay - m_position );
+		std::swap_ranges( buf + done, buf + done + chunk, m_buffer.get() + m_position );
+		done += chunk;
+		m_position += chunk;
+		if( m_position == m_delay )
+		{
+			m_position = 0;
+		}
+	}
+
+	m_tail = active ? m_delay : std::max<f_cnt_t>( m_tail - frames, 0 );
+}
+
+
+} // namespace lmms
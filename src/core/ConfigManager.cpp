@@ -222,6 +222,12 @@ bool ConfigManager::hasWorkingDir() const
 }
 
 
+QString ConfigManager::cacheDir() const
+{
+	return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/lmms/";
+}
+
+
 void ConfigManager::setWorkingDir(const QString & workingDir)
 {
 	m_workingDir = ensureTrailingSlash(QDir::cleanPath(workingDir));
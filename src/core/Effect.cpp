@@ -31,6 +31,7 @@
 #include "EffectView.h"
 
 #include "ConfigManager.h"
+#include "Mixer.h"
 
 namespace lmms
 {
@@ -59,6 +60,13 @@ Effect::Effect( const Plugin::Descriptor * _desc,
 	{
 		m_autoQuitDisabled = true;
 	}
+
+	// disabled effects don't count towards the latency of their chain
+	if( Engine::mixer() )
+	{
+		connect( &m_enabledModel, SIGNAL( dataChanged() ),
+			Engine::mixer(), SLOT( requestLatencyUpdate() ), Qt::DirectConnection );
+	}
 }
 
 
@@ -27,9 +27,11 @@
 #include <QDomElement>
 
 #include "EffectChain.h"
+#include "AudioEngine.h"
 #include "Effect.h"
 #include "DummyEffect.h"
 #include "MixHelpers.h"
+#include "Mixer.h"
 
 namespace lmms
 {
@@ -40,6 +42,8 @@ EffectChain::EffectChain( Model * _parent ) :
 	SerializingObject(),
 	m_enabledModel( false, nullptr, tr( "Effects enabled" ) )
 {
+	connect( &m_enabledModel, SIGNAL( dataChanged() ),
+			this, SLOT( invalidateLatency() ), Qt::DirectConnection );
 }
 
 
@@ -115,6 +119,8 @@ void EffectChain::loadSettings( const QDomElement & _this )
 		node = node.nextSibling();
 	}
 
+	publishEffects();
+
 	emit dataChanged();
 }
 
@@ -123,9 +129,8 @@ void EffectChain::loadSettings( const QDomElement & _this )
 
 void EffectChain::appendEffect( Effect * _effect )
 {
-	Engine::audioEngine()->requestChangeInModel();
 	m_effects.append( _effect );
-	Engine::audioEngine()->doneChangeInModel();
+	publishEffects();
 
 	m_enabledModel.setValue( true );
 
@@ -137,17 +142,19 @@ void EffectChain::appendEffect( Effect * _effect )
 
 void EffectChain::removeEffect( Effect * _effect )
 {
-	Engine::audioEngine()->requestChangeInModel();
-
 	Effect ** found = std::find( m_effects.begin(), m_effects.end(), _effect );
 	if( found == m_effects.end() )
 	{
-		Engine::audioEngine()->doneChangeInModel();
 		return;
 	}
 	m_effects.erase( found );
 
-	Engine::audioEngine()->doneChangeInModel();
+	publishEffects();
+	// the caller deletes the effect afterwards
+	if( Engine::audioEngine() )
+	{
+		Engine::audioEngine()->waitForPostedChanges();
+	}
 
 	if( m_effects.isEmpty() )
 	{
@@ -166,6 +173,7 @@ void EffectChain::moveDown( Effect * _effect )
 	{
 		int i = m_effects.indexOf(_effect);
 		std::swap(m_effects[i + 1], m_effects[i]);
+		publishEffects();
 	}
 }
 
@@ -178,6 +186,7 @@ void EffectChain::moveUp( Effect * _effect )
 	{
 		int i = m_effects.indexOf(_effect);
 		std::swap(m_effects[i - 1], m_effects[i]);
+		publishEffects();
 	}
 }
 
@@ -194,7 +203,7 @@ bool EffectChain::processAudioBuffer( sampleFrame * _buf, const fpp_t _frames, b
 	MixHelpers::sanitize( _buf, _frames );
 
 	bool moreEffects = false;
-	for( EffectList::Iterator it = m_effects.begin(); it != m_effects.end(); ++it )
+	for( EffectList::Iterator it = m_processedEffects.begin(); it != m_processedEffects.end(); ++it )
 	{
 		if( hasInputNoise || ( *it )->isRunning() )
 		{
@@ -209,6 +218,27 @@ bool EffectChain::processAudioBuffer( sampleFrame * _buf, const fpp_t _frames, b
 
 
 
+f_cnt_t EffectChain::latency() const
+{
+	if( m_enabledModel.value() == false )
+	{
+		return 0;
+	}
+
+	f_cnt_t sum = 0;
+	for( const Effect * effect : m_processedEffects )
+	{
+		if( effect->isEnabled() )
+		{
+			sum += effect->latency();
+		}
+	}
+	return sum;
+}
+
+
+
+
 void EffectChain::startRunning()
 {
 	if( m_enabledModel.value() == false )
@@ -216,8 +246,8 @@ void EffectChain::startRunning()
 		return;
 	}
 
-	for( EffectList::Iterator it = m_effects.begin();
-						it != m_effects.end(); it++ )
+	for( EffectList::Iterator it = m_processedEffects.begin();
+						it != m_processedEffects.end(); it++ )
 	{
 		( *it )->startRunning();
 	}
@@ -230,19 +260,56 @@ void EffectChain::clear()
 {
 	emit aboutToClear();
 
-	Engine::audioEngine()->requestChangeInModel();
+	EffectList effects;
+	effects.swap( m_effects );
+	publishEffects();
+	// the audio thread must not process them anymore when they are deleted
+	if( Engine::audioEngine() )
+	{
+		Engine::audioEngine()->waitForPostedChanges();
+	}
 
-	while( m_effects.count() )
+	while( effects.count() )
 	{
-		Effect * e = m_effects[m_effects.count() - 1];
-		m_effects.pop_back();
+		Effect * e = effects[effects.count() - 1];
+		effects.pop_back();
 		delete e;
 	}
 
-	Engine::audioEngine()->doneChangeInModel();
-
 	m_enabledModel.setValue( false );
 }
 
 
+
+
+void EffectChain::publishEffects()
+{
+	if( Engine::audioEngine() == nullptr )
+	{
+		m_processedEffects = m_effects;
+		invalidateLatency();
+		return;
+	}
+
+	// the old list ends up in the posted change and is freed along with it,
+	// outside of the audio thread
+	Engine::audioEngine()->postChangeInModel( [this, effects = m_effects]() mutable {
+		m_processedEffects.swap( effects );
+		invalidateLatency();
+	} );
+}
+
+
+
+
+void EffectChain::invalidateLatency()
+{
+	// the master channel's chain is created before the mixer is registered
+	if( Engine::mixer() )
+	{
+		Engine::mixer()->requestLatencyUpdate();
+	}
+}
+
+
 } // namespace lmms
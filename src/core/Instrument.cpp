@@ -43,6 +43,20 @@ Instrument::Instrument(InstrumentTrack * _instrument_track,
 {
 }
 
+
+
+
+void Instrument::latencyChanged()
+{
+	if( m_instrumentTrack )
+	{
+		m_instrumentTrack->audioPort()->setSourceLatency( latency() );
+	}
+}
+
+
+
+
 void Instrument::play( sampleFrame * )
 {
 }
@@ -174,10 +174,34 @@ void InstrumentSoundShaping::processAudioBuffer( sampleFrame* buffer,
 		const float fcv = m_filterCutModel.value();
 		const float frv = m_filterResModel.value();
 
-		if( m_envLfoParameters[Cut]->isUsed() &&
-			m_envLfoParameters[Resonance]->isUsed() )
+		// the filter type is only looked at once per period, coefficients
+		// are only recalculated when the envelopes moved far enough
+		BasicFilters<> & filter = *n->m_filter;
+		const bool cutUsed = m_envLfoParameters[Cut]->isUsed();
+		const bool resUsed = m_envLfoParameters[Resonance]->isUsed();
+		const fpp_t interval = Engine::audioEngine()->currentQualitySettings().filterControlInterval();
+		if( interval > 1 && ( cutUsed || resUsed ) )
 		{
-			for( fpp_t frame = 0; frame < frames; ++frame )
+			// calculate coefficients at control rate only and glide
+			// towards them in between
+			filter.process( buffer, frames, [&]( fpp_t frame )
+			{
+				if( frame % interval == 0 )
+				{
+					const fpp_t last = qMin<fpp_t>( frame + interval, frames ) - 1;
+					const float cut = cutUsed
+						? EnvelopeAndLfoParameters::expKnobVal( cutBuffer[last] ) *
+								CUT_FREQ_MULTIPLIER + fcv
+						: fcv;
+					const float res = resUsed ? frv + RES_MULTIPLIER * resBuffer[last] : frv;
+					filter.glideFilterCoeffs( cut, res, last - frame + 1 );
+				}
+				filter.stepFilterCoeffs();
+			} );
+		}
+		else if( cutUsed && resUsed )
+		{
+			filter.process( buffer, frames, [&]( fpp_t frame )
 			{
 				const float new_cut_val = EnvelopeAndLfoParameters::expKnobVal( cutBuffer[frame] ) *
 								CUT_FREQ_MULTIPLIER + fcv;
@@ -187,57 +211,43 @@ void InstrumentSoundShaping::processAudioBuffer( sampleFrame* buffer,
 				if( static_cast<int>( new_cut_val ) != old_filter_cut ||
 					static_cast<int>( new_res_val*RES_PRECISION ) != old_filter_res )
 				{
-					n->m_filter->calcFilterCoeffs( new_cut_val, new_res_val );
+					filter.calcFilterCoeffs( new_cut_val, new_res_val );
 					old_filter_cut = static_cast<int>( new_cut_val );
 					old_filter_res = static_cast<int>( new_res_val*RES_PRECISION );
 				}
-
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
+			} );
 		}
-		else if( m_envLfoParameters[Cut]->isUsed() )
+		else if( cutUsed )
 		{
-			for( fpp_t frame = 0; frame < frames; ++frame )
+			filter.process( buffer, frames, [&]( fpp_t frame )
 			{
 				float new_cut_val = EnvelopeAndLfoParameters::expKnobVal( cutBuffer[frame] ) *
 								CUT_FREQ_MULTIPLIER + fcv;
 
 				if( static_cast<int>( new_cut_val ) != old_filter_cut )
 				{
-					n->m_filter->calcFilterCoeffs( new_cut_val, frv );
+					filter.calcFilterCoeffs( new_cut_val, frv );
 					old_filter_cut = static_cast<int>( new_cut_val );
 				}
-
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
+			} );
 		}
-		else if( m_envLfoParameters[Resonance]->isUsed() )
+		else if( resUsed )
 		{
-			for( fpp_t frame = 0; frame < frames; ++frame )
+			filter.process( buffer, frames, [&]( fpp_t frame )
 			{
 				float new_res_val = frv + RES_MULTIPLIER * resBuffer[frame];
 
 				if( static_cast<int>( new_res_val*RES_PRECISION ) != old_filter_res )
 				{
-					n->m_filter->calcFilterCoeffs( fcv, new_res_val );
+					filter.calcFilterCoeffs( fcv, new_res_val );
 					old_filter_res = static_cast<int>( new_res_val*RES_PRECISION );
 				}
-
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
+			} );
 		}
 		else
 		{
-			n->m_filter->calcFilterCoeffs( fcv, frv );
-
-			for( fpp_t frame = 0; frame < frames; ++frame )
-			{
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
+			filter.calcFilterCoeffs( fcv, frv );
+			filter.process( buffer, frames, []( fpp_t ) {} );
 		}
 	}
 
@@ -25,14 +25,18 @@
  */
 
 #include <QCoreApplication>
+#include <QDataStream>
 #include <QDebug>
 #include <QDir>
 #include <QLibrary>
+#include <QMutexLocker>
+#include <QVector>
 
 #include <cmath>
 
 #include "ConfigManager.h"
 #include "LadspaManager.h"
+#include "PluginDescriptorCache.h"
 #include "PluginFactory.h"
 
 
@@ -40,6 +44,38 @@ namespace lmms
 {
 
 
+namespace
+{
+
+// What is cached about each plugin of a library
+struct CachedPlugin
+{
+	QString label;
+	QString name;
+	quint32 index;
+	qint32 type;
+	quint16 inputChannels;
+	quint16 outputChannels;
+	qint32 properties;
+} ;
+
+QDataStream & operator<<( QDataStream & _stream, const CachedPlugin & _plugin )
+{
+	return _stream << _plugin.label << _plugin.name << _plugin.index
+		<< _plugin.type << _plugin.inputChannels
+		<< _plugin.outputChannels << _plugin.properties;
+}
+
+QDataStream & operator>>( QDataStream & _stream, CachedPlugin & _plugin )
+{
+	return _stream >> _plugin.label >> _plugin.name >> _plugin.index
+		>> _plugin.type >> _plugin.inputChannels
+		>> _plugin.outputChannels >> _plugin.properties;
+}
+
+}
+
+
 LadspaManager::LadspaManager()
 {
 	// Make sure plugin search paths are set up
@@ -82,23 +118,23 @@ LadspaManager::LadspaManager()
 				continue;
 			}
 
-			QLibrary plugin_lib( f.absoluteFilePath() );
-
-			if( plugin_lib.load() == true )
+			LADSPA_Descriptor_Function descriptorFunction = nullptr;
+			QByteArray plugins = cache.find( f );
+			if( plugins.isNull() )
 			{
-				LADSPA_Descriptor_Function descriptorFunction =
-			( LADSPA_Descriptor_Function ) plugin_lib.resolve(
-							"ladspa_descriptor" );
-				if( descriptorFunction != nullptr )
+				QLibrary plugin_lib( f.absoluteFilePath() );
+				if( plugin_lib.load() == false )
 				{
-					addPlugins( descriptorFunction,
-							f.fileName() );
+					qWarning() << plugin_lib.errorString();
+					continue;
 				}
+				descriptorFunction =
+			( LADSPA_Descriptor_Function ) plugin_lib.resolve(
+							"ladspa_descriptor" );
+				plugins = describePlugins( descriptorFunction );
+				cache.insert( f, plugins );
 			}
-			else
-			{
-				qWarning() << plugin_lib.errorString();
-			}
+			addPlugins( plugins, f, descriptorFunction );
 		}
 	}
 	
@@ -142,48 +178,82 @@ LadspaManagerDescription * LadspaManager::getDescription(
 
 
 
-void LadspaManager::addPlugins(
-		LADSPA_Descriptor_Function _descriptor_func,
-						const QString & _file )
+QByteArray LadspaManager::describePlugins(
+		LADSPA_Descriptor_Function _descriptor_func )
 {
+	QVector<CachedPlugin> plugins;
 	const LADSPA_Descriptor * descriptor;
 
-	for( long pluginIndex = 0;
+	for( long pluginIndex = 0; _descriptor_func != nullptr &&
 		( descriptor = _descriptor_func( pluginIndex ) ) != nullptr;
 								++pluginIndex )
 	{
-		ladspa_key_t key( _file, QString( descriptor->Label ) );
-		if( m_ladspaManagerMap.contains( key ) )
+		CachedPlugin plugIn;
+		plugIn.label = descriptor->Label;
+		plugIn.name = descriptor->Name;
+		plugIn.index = pluginIndex;
+		plugIn.inputChannels = getPluginInputs( descriptor );
+		plugIn.outputChannels = getPluginOutputs( descriptor );
+		plugIn.properties = descriptor->Properties;
+
+		if( plugIn.inputChannels == 0 && plugIn.outputChannels > 0 )
 		{
-			continue;
+			plugIn.type = SOURCE;
 		}
-
-		LadspaManagerDescription * plugIn = 
-				new LadspaManagerDescription;
-		plugIn->descriptorFunction = _descriptor_func;
-		plugIn->index = pluginIndex;
-		plugIn->inputChannels = getPluginInputs( descriptor );
-		plugIn->outputChannels = getPluginOutputs( descriptor );
-
-		if( plugIn->inputChannels == 0 && plugIn->outputChannels > 0 )
+		else if( plugIn.inputChannels > 0 &&
+				       plugIn.outputChannels > 0 )
 		{
-			plugIn->type = SOURCE;
+			plugIn.type = TRANSFER;
 		}
-		else if( plugIn->inputChannels > 0 &&
-				       plugIn->outputChannels > 0 )
+		else if( plugIn.inputChannels > 0 &&
+				       plugIn.outputChannels == 0 )
 		{
-			plugIn->type = TRANSFER;
+			plugIn.type = SINK;
 		}
-		else if( plugIn->inputChannels > 0 &&
-				       plugIn->outputChannels == 0 )
+		else
 		{
-			plugIn->type = SINK;
+			plugIn.type = OTHER;
 		}
-		else
+
+		plugins.push_back( plugIn );
+	}
+
+	QByteArray data;
+	QDataStream stream( &data, QIODevice::WriteOnly );
+	stream << plugins;
+	return data;
+}
+
+
+
+
+void LadspaManager::addPlugins( const QByteArray & _plugins,
+					const QFileInfo & _file,
+				LADSPA_Descriptor_Function _descriptor_func )
+{
+	QVector<CachedPlugin> plugins;
+	QDataStream stream( _plugins );
+	stream >> plugins;
+
+	for( const CachedPlugin & cached : plugins )
+	{
+		ladspa_key_t key( _file.fileName(), cached.label );
+		if( m_ladspaManagerMap.contains( key ) )
 		{
-			plugIn->type = OTHER;
+			continue;
 		}
 
+		LadspaManagerDescription * plugIn = 
+				new LadspaManagerDescription;
+		plugIn->descriptorFunction = _descriptor_func;
+		plugIn->file = _file.absoluteFilePath();
+		plugIn->index = cached.index;
+		plugIn->type = static_cast<LadspaPluginType>( cached.type );
+		plugIn->inputChannels = cached.inputChannels;
+		plugIn->outputChannels = cached.outputChannels;
+		plugIn->name = cached.name;
+		plugIn->properties = cached.properties;
+
 		m_ladspaManagerMap[key] = plugIn;
 	}
 }
@@ -191,6 +261,29 @@ void LadspaManager::addPlugins(
 
 
 
+LADSPA_Descriptor_Function LadspaManager::loadLibrary(
+					LadspaManagerDescription * _plugin )
+{
+	QMutexLocker lock( &m_loadMutex );
+	if( _plugin->descriptorFunction == nullptr )
+	{
+		// the library stays loaded, like the ones loaded at startup
+		QLibrary plugin_lib( _plugin->file );
+		if( plugin_lib.load() == false )
+		{
+			qWarning() << plugin_lib.errorString();
+			return nullptr;
+		}
+		_plugin->descriptorFunction =
+			( LADSPA_Descriptor_Function ) plugin_lib.resolve(
+							"ladspa_descriptor" );
+	}
+	return _plugin->descriptorFunction;
+}
+
+
+
+
 uint16_t LadspaManager::getPluginInputs(
 		const LADSPA_Descriptor * _descriptor )
 {
@@ -283,9 +376,8 @@ QString LadspaManager::getLabel( const ladspa_key_t & _plugin )
 bool LadspaManager::hasRealTimeDependency(
 					const ladspa_key_t &  _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? LADSPA_IS_REALTIME( descriptor->Properties )
-					   : false );
+	const LadspaManagerDescription * plugIn = getDescription( _plugin );
+	return( plugIn ? LADSPA_IS_REALTIME( plugIn->properties ) : false );
 }
 
 
@@ -293,9 +385,8 @@ bool LadspaManager::hasRealTimeDependency(
 
 bool LadspaManager::isInplaceBroken( const ladspa_key_t &  _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? LADSPA_IS_INPLACE_BROKEN( descriptor->Properties )
-					   : false );
+	const LadspaManagerDescription * plugIn = getDescription( _plugin );
+	return( plugIn ? LADSPA_IS_INPLACE_BROKEN( plugIn->properties ) : false );
 }
 
 
@@ -304,9 +395,8 @@ bool LadspaManager::isInplaceBroken( const ladspa_key_t &  _plugin )
 bool LadspaManager::isRealTimeCapable(
 					const ladspa_key_t &  _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? LADSPA_IS_HARD_RT_CAPABLE( descriptor->Properties )
-					   : false );
+	const LadspaManagerDescription * plugIn = getDescription( _plugin );
+	return( plugIn ? LADSPA_IS_HARD_RT_CAPABLE( plugIn->properties ) : false );
 }
 
 
@@ -314,8 +404,8 @@ bool LadspaManager::isRealTimeCapable(
 
 QString LadspaManager::getName( const ladspa_key_t & _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? descriptor->Name : "" );
+	const LadspaManagerDescription * plugIn = getDescription( _plugin );
+	return( plugIn ? plugIn->name : "" );
 }
 
 
@@ -531,14 +621,9 @@ bool LadspaManager::isInteger( const ladspa_key_t & _plugin,
 
 bool LadspaManager::isEnum( const ladspa_key_t & _plugin, uint32_t _port )
 {
-	if( m_ladspaManagerMap.contains( _plugin )
-		   && _port < getPortCount( _plugin ) )
+	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
+	if( descriptor && _port < descriptor->PortCount )
 	{
-		LADSPA_Descriptor_Function descriptorFunction =
-			m_ladspaManagerMap[_plugin]->descriptorFunction;
-		const LADSPA_Descriptor * descriptor =
-				descriptorFunction(
-					m_ladspaManagerMap[_plugin]->index );
 		LADSPA_PortRangeHintDescriptor hintDescriptor =
 			descriptor->PortRangeHints[_port].HintDescriptor;
 		// This is an LMMS extension to ladspa
@@ -579,12 +664,15 @@ const LADSPA_Descriptor * LadspaManager::getDescriptor(
 {
 	if( m_ladspaManagerMap.contains( _plugin ) )
 	{
+		LadspaManagerDescription * plugIn = m_ladspaManagerMap[_plugin];
 		LADSPA_Descriptor_Function descriptorFunction =
-			m_ladspaManagerMap[_plugin]->descriptorFunction;
-		const LADSPA_Descriptor * descriptor =
-				descriptorFunction(
-					m_ladspaManagerMap[_plugin]->index );
-		return( descriptor );
+						plugIn->descriptorFunction;
+		if( descriptorFunction == nullptr )
+		{
+			descriptorFunction = loadLibrary( plugIn );
+		}
+		return( descriptorFunction ?
+				descriptorFunction( plugIn->index ) : nullptr );
 	}
 	else
 	{
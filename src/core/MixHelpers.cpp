@@ -31,8 +31,13 @@
 #include <cmath>
 #include <QtGlobal>
 
+#include "MixHelpersKernels.h"
 #include "ValueBuffer.h"
 
+#if defined(_MSC_VER) && ( defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64) )
+#include <intrin.h>
+#endif
+
 
 
 static bool s_NaNHandler;
@@ -63,41 +68,114 @@ static inline void run( sampleFrame* dst, const sample_t* srcLeft, const sample_
 }
 
 
+static inline float* asFloats( sampleFrame* buf )
+{
+	return reinterpret_cast<float*>( buf );
+}
 
-bool isSilent( const sampleFrame* src, int frames )
+static inline const float* asFloats( const sampleFrame* buf )
 {
-	const float silenceThreshold = 0.0000001f;
+	return reinterpret_cast<const float*>( buf );
+}
 
-	for( int i = 0; i < frames; ++i )
+static inline sampleFrame* asFrames( float* buf )
+{
+	return reinterpret_cast<sampleFrame*>( buf );
+}
+
+static inline const sampleFrame* asFrames( const float* buf )
+{
+	return reinterpret_cast<const sampleFrame*>( buf );
+}
+
+
+
+
+struct AddOp
+{
+	void operator()( sampleFrame& dst, const sampleFrame& src ) const
 	{
-		if( fabsf( src[i][0] ) >= silenceThreshold || fabsf( src[i][1] ) >= silenceThreshold )
-		{
-			return false;
-		}
+		dst[0] += src[0];
+		dst[1] += src[1];
 	}
+} ;
 
-	return true;
+
+struct AddMultipliedOp
+{
+	AddMultipliedOp( float coeff ) : m_coeff( coeff ) { }
+
+	void operator()( sampleFrame& dst, const sampleFrame& src ) const
+	{
+		dst[0] += src[0] * m_coeff;
+		dst[1] += src[1] * m_coeff;
+	}
+
+	const float m_coeff;
+} ;
+
+
+struct AddSanitizedMultipliedOp
+{
+	AddSanitizedMultipliedOp( float coeff ) : m_coeff( coeff ) { }
+
+	void operator()( sampleFrame& dst, const sampleFrame& src ) const
+	{
+		dst[0] += ( std::isinf( src[0] ) || std::isnan( src[0] ) ) ? 0.0f : src[0] * m_coeff;
+		dst[1] += ( std::isinf( src[1] ) || std::isnan( src[1] ) ) ? 0.0f : src[1] * m_coeff;
+	}
+
+	const float m_coeff;
+};
+
+
+// plain C++ versions of the kernels, used if the CPU has nothing better
+namespace scalar
+{
+
+static void add( float* dst, const float* src, int frames )
+{
+	run<>( asFrames( dst ), asFrames( src ), frames, AddOp() );
 }
 
-bool useNaNHandler()
+static void addMultiplied( float* dst, const float* src, float coeff, int frames )
 {
-	return s_NaNHandler;
+	run<>( asFrames( dst ), asFrames( src ), frames, AddMultipliedOp( coeff ) );
 }
 
-void setNaNHandler( bool use )
+static void addSanitizedMultiplied( float* dst, const float* src, float coeff, int frames )
 {
-	s_NaNHandler = use;
+	run<>( asFrames( dst ), asFrames( src ), frames, AddSanitizedMultipliedOp( coeff ) );
 }
 
-/*! \brief Function for sanitizing a buffer of infs/nans - returns true if those are found */
-bool sanitize( sampleFrame * src, int frames )
+static void addMultipliedByBuffers( float* dst, const float* src, float coeff,
+				const float* coeffBuf1, const float* coeffBuf2, int frames )
 {
-	if( !useNaNHandler() )
+	for( int f = 0; f < frames; ++f )
 	{
-		return false;
+		const float gain = coeff * coeffBuf1[f] * ( coeffBuf2 ? coeffBuf2[f] : 1.0f );
+		dst[2 * f] += src[2 * f] * gain;
+		dst[2 * f + 1] += src[2 * f + 1] * gain;
 	}
+}
 
-	bool found = false;
+static void addSanitizedMultipliedByBuffers( float* dst, const float* src, float coeff,
+				const float* coeffBuf1, const float* coeffBuf2, int frames )
+{
+	for( int f = 0; f < frames; ++f )
+	{
+		const float gain = coeff * coeffBuf1[f] * ( coeffBuf2 ? coeffBuf2[f] : 1.0f );
+		for( int c = 0; c < 2; ++c )
+		{
+			const float s = src[2 * f + c];
+			dst[2 * f + c] += ( std::isinf( s ) || std::isnan( s ) ) ? 0.0f : s * gain;
+		}
+	}
+}
+
+static bool sanitize( float* buf, int frames )
+{
+	sampleFrame* src = asFrames( buf );
 	for( int f = 0; f < frames; ++f )
 	{
 		for( int c = 0; c < 2; ++c )
@@ -116,8 +194,7 @@ bool sanitize( sampleFrame * src, int frames )
 						src[f][c] = 0.0f;
 					}
 				}
-				found = true;
-				return found;
+				return true;
 			}
 			else
 			{
@@ -125,43 +202,261 @@ bool sanitize( sampleFrame * src, int frames )
 			}
 		}
 	}
-	return found;
+	return false;
 }
 
+static bool isSilent( const float* buf, int frames )
+{
+	const float silenceThreshold = 0.0000001f;
 
-struct AddOp
+	const sampleFrame* src = asFrames( buf );
+	for( int i = 0; i < frames; ++i )
+	{
+		if( fabsf( src[i][0] ) >= silenceThreshold || fabsf( src[i][1] ) >= silenceThreshold )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void peak( const float* buf, int frames, float* left, float* right )
 {
-	void operator()( sampleFrame& dst, const sampleFrame& src ) const
+	const sampleFrame* src = asFrames( buf );
+	for( int f = 0; f < frames; ++f )
 	{
-		dst[0] += src[0];
-		dst[1] += src[1];
+		const float absLeft = fabsf( src[f][0] );
+		const float absRight = fabsf( src[f][1] );
+		if( absLeft > *left )
+		{
+			*left = absLeft;
+		}
+		if( absRight > *right )
+		{
+			*right = absRight;
+		}
 	}
-} ;
+}
 
-void add( sampleFrame* dst, const sampleFrame* src, int frames )
+static void multiply( float* buf, float left, float right, int frames )
 {
-	run<>( dst, src, frames, AddOp() );
+	for( int f = 0; f < frames; ++f )
+	{
+		buf[2 * f] *= left;
+		buf[2 * f + 1] *= right;
+	}
 }
 
+static void multiplyByBuffer( float* buf, const float* coeffBuf, float left, float right, int frames )
+{
+	for( int f = 0; f < frames; ++f )
+	{
+		buf[2 * f] *= coeffBuf[f] * left;
+		buf[2 * f + 1] *= coeffBuf[f] * right;
+	}
+}
 
+static void multiplyByPanningBuffer( float* buf, const float* volumeBuf, float volume,
+				const float* panningBuf, float panningScale, int frames )
+{
+	for( int f = 0; f < frames; ++f )
+	{
+		const float p = panningBuf[f] * panningScale;
+		const float v = volumeBuf ? volumeBuf[f] * volume : volume;
+		buf[2 * f] *= ( p <= 0 ? 1.0f : 1.0f - p ) * v;
+		buf[2 * f + 1] *= ( p >= 0 ? 1.0f : 1.0f + p ) * v;
+	}
+}
 
-struct AddMultipliedOp
+static const Kernels kernels = {
+	&add,
+	&addMultiplied,
+	&addSanitizedMultiplied,
+	&addMultipliedByBuffers,
+	&addSanitizedMultipliedByBuffers,
+	&sanitize,
+	&isSilent,
+	&peak,
+	&multiply,
+	&multiplyByBuffer,
+	&multiplyByPanningBuffer
+};
+
+} // namespace scalar
+
+
+
+
+static bool cpuSupports( Isa isa )
 {
-	AddMultipliedOp( float coeff ) : m_coeff( coeff ) { }
+	if( isa == Isa::Scalar )
+	{
+		return true;
+	}
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid( info, 1 );
+	const bool sse2 = info[3] & ( 1 << 26 );
+	// the OS has to save the AVX registers for us, too
+	const bool osxsave = info[2] & ( 1 << 27 );
+	const unsigned long long xcr0 = osxsave ? _xgetbv( 0 ) : 0;
+	__cpuidex( info, 7, 0 );
+	const bool avx2 = ( xcr0 & 0x06 ) == 0x06 && ( info[1] & ( 1 << 5 ) );
+	const bool avx512 = ( xcr0 & 0xe6 ) == 0xe6 && ( info[1] & ( 1 << 16 ) );
+#else
+	__builtin_cpu_init();
+	const bool sse2 = __builtin_cpu_supports( "sse2" );
+	const bool avx2 = __builtin_cpu_supports( "avx2" );
+	const bool avx512 = __builtin_cpu_supports( "avx512f" );
+#endif
+	switch( isa )
+	{
+		case Isa::Sse2: return sse2;
+		case Isa::Avx2: return avx2;
+		case Isa::Avx512: return avx512;
+		default: break;
+	}
+#endif
+	return false;
+}
 
-	void operator()( sampleFrame& dst, const sampleFrame& src ) const
+
+
+
+static const Kernels* kernelsFor( Isa isa )
+{
+	switch( isa )
 	{
-		dst[0] += src[0] * m_coeff;
-		dst[1] += src[1] * m_coeff;
+		case Isa::Sse2: return sse2Kernels();
+		case Isa::Avx2: return avx2Kernels();
+		case Isa::Avx512: return avx512Kernels();
+		default: return &scalar::kernels;
 	}
+}
+
+
+
+
+static Isa bestIsa()
+{
+	for( Isa isa : { Isa::Avx512, Isa::Avx2, Isa::Sse2 } )
+	{
+		if( isaSupported( isa ) )
+		{
+			return isa;
+		}
+	}
+	return Isa::Scalar;
+}
+
+
+
+
+static Isa& activeIsa()
+{
+	static Isa isa = bestIsa();
+	return isa;
+}
 
-	const float m_coeff;
-} ;
+
+
+
+static const Kernels*& activeKernels()
+{
+	static const Kernels* kernels = kernelsFor( activeIsa() );
+	return kernels;
+}
+
+
+
+
+static inline const Kernels& kernels()
+{
+	return *activeKernels();
+}
+
+
+
+
+bool isaSupported( Isa isa )
+{
+	return kernelsFor( isa ) != nullptr && cpuSupports( isa );
+}
+
+Isa isa()
+{
+	return activeIsa();
+}
+
+bool setIsa( Isa isa )
+{
+	if( ! isaSupported( isa ) )
+	{
+		return false;
+	}
+	activeIsa() = isa;
+	activeKernels() = kernelsFor( isa );
+	return true;
+}
+
+const char* isaName( Isa isa )
+{
+	switch( isa )
+	{
+		case Isa::Sse2: return "SSE2";
+		case Isa::Avx2: return "AVX2";
+		case Isa::Avx512: return "AVX-512";
+		default: return "scalar";
+	}
+}
+
+
+
+
+bool isSilent( const sampleFrame* src, int frames )
+{
+	return kernels().isSilent( asFloats( src ), frames );
+}
+
+bool useNaNHandler()
+{
+	return s_NaNHandler;
+}
+
+void setNaNHandler( bool use )
+{
+	s_NaNHandler = use;
+}
+
+/*! \brief Function for sanitizing a buffer of infs/nans - returns true if those are found */
+bool sanitize( sampleFrame * src, int frames )
+{
+	if( !useNaNHandler() )
+	{
+		return false;
+	}
+
+	return kernels().sanitize( asFloats( src ), frames );
+}
+
+
+void peak( const sampleFrame* src, int frames, float& left, float& right )
+{
+	kernels().peak( asFloats( src ), frames, &left, &right );
+}
+
+
+void add( sampleFrame* dst, const sampleFrame* src, int frames )
+{
+	kernels().add( asFloats( dst ), asFloats( src ), frames );
+}
 
 
 void addMultiplied( sampleFrame* dst, const sampleFrame* src, float coeffSrc, int frames )
 {
-	run<>( dst, src, frames, AddMultipliedOp(coeffSrc) );
+	kernels().addMultiplied( asFloats( dst ), asFloats( src ), coeffSrc, frames );
 }
 
 
@@ -186,21 +481,14 @@ void addSwappedMultiplied( sampleFrame* dst, const sampleFrame* src, float coeff
 
 void addMultipliedByBuffer( sampleFrame* dst, const sampleFrame* src, float coeffSrc, ValueBuffer * coeffSrcBuf, int frames )
 {
-	for( int f = 0; f < frames; ++f )
-	{
-		dst[f][0] += src[f][0] * coeffSrc * coeffSrcBuf->values()[f];
-		dst[f][1] += src[f][1] * coeffSrc * coeffSrcBuf->values()[f];
-	}
+	kernels().addMultipliedByBuffers( asFloats( dst ), asFloats( src ), coeffSrc,
+						coeffSrcBuf->values(), nullptr, frames );
 }
 
 void addMultipliedByBuffers( sampleFrame* dst, const sampleFrame* src, ValueBuffer * coeffSrcBuf1, ValueBuffer * coeffSrcBuf2, int frames )
 {
-	for( int f = 0; f < frames; ++f )
-	{
-		dst[f][0] += src[f][0] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
-		dst[f][1] += src[f][1] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
-	}
-
+	kernels().addMultipliedByBuffers( asFloats( dst ), asFloats( src ), 1.0f,
+						coeffSrcBuf1->values(), coeffSrcBuf2->values(), frames );
 }
 
 void addSanitizedMultipliedByBuffer( sampleFrame* dst, const sampleFrame* src, float coeffSrc, ValueBuffer * coeffSrcBuf, int frames )
@@ -212,11 +500,8 @@ void addSanitizedMultipliedByBuffer( sampleFrame* dst, const sampleFrame* src, f
 		return;
 	}
 
-	for( int f = 0; f < frames; ++f )
-	{
-		dst[f][0] += ( std::isinf( src[f][0] ) || std::isnan( src[f][0] ) ) ? 0.0f : src[f][0] * coeffSrc * coeffSrcBuf->values()[f];
-		dst[f][1] += ( std::isinf( src[f][1] ) || std::isnan( src[f][1] ) ) ? 0.0f : src[f][1] * coeffSrc * coeffSrcBuf->values()[f];
-	}
+	kernels().addSanitizedMultipliedByBuffers( asFloats( dst ), asFloats( src ), coeffSrc,
+						coeffSrcBuf->values(), nullptr, frames );
 }
 
 void addSanitizedMultipliedByBuffers( sampleFrame* dst, const sampleFrame* src, ValueBuffer * coeffSrcBuf1, ValueBuffer * coeffSrcBuf2, int frames )
@@ -228,32 +513,11 @@ void addSanitizedMultipliedByBuffers( sampleFrame* dst, const sampleFrame* src,
 		return;
 	}
 
-	for( int f = 0; f < frames; ++f )
-	{
-		dst[f][0] += ( std::isinf( src[f][0] ) || std::isnan( src[f][0] ) )
-			? 0.0f
-			: src[f][0] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
-		dst[f][1] += ( std::isinf( src[f][1] ) || std::isnan( src[f][1] ) )
-			? 0.0f
-			: src[f][1] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
-	}
-
+	kernels().addSanitizedMultipliedByBuffers( asFloats( dst ), asFloats( src ), 1.0f,
+						coeffSrcBuf1->values(), coeffSrcBuf2->values(), frames );
 }
 
 
-struct AddSanitizedMultipliedOp
-{
-	AddSanitizedMultipliedOp( float coeff ) : m_coeff( coeff ) { }
-
-	void operator()( sampleFrame& dst, const sampleFrame& src ) const
-	{
-		dst[0] += ( std::isinf( src[0] ) || std::isnan( src[0] ) ) ? 0.0f : src[0] * m_coeff;
-		dst[1] += ( std::isinf( src[1] ) || std::isnan( src[1] ) ) ? 0.0f : src[1] * m_coeff;
-	}
-
-	const float m_coeff;
-};
-
 void addSanitizedMultiplied( sampleFrame* dst, const sampleFrame* src, float coeffSrc, int frames )
 {
 	if ( !useNaNHandler() )
@@ -262,7 +526,27 @@ void addSanitizedMultiplied( sampleFrame* dst, const sampleFrame* src, float coe
 		return;
 	}
 
-	run<>( dst, src, frames, AddSanitizedMultipliedOp(coeffSrc) );
+	kernels().addSanitizedMultiplied( asFloats( dst ), asFloats( src ), coeffSrc, frames );
+}
+
+
+void multiply( sampleFrame* buf, float left, float right, int frames )
+{
+	kernels().multiply( asFloats( buf ), left, right, frames );
+}
+
+
+void multiplyByBuffer( sampleFrame* buf, const ValueBuffer * coeffBuf, float left, float right, int frames )
+{
+	kernels().multiplyByBuffer( asFloats( buf ), coeffBuf->values(), left, right, frames );
+}
+
+
+void multiplyByPanningBuffer( sampleFrame* buf, const ValueBuffer * volumeBuf, float volume,
+				const ValueBuffer * panningBuf, float panningScale, int frames )
+{
+	kernels().multiplyByPanningBuffer( asFloats( buf ), volumeBuf ? volumeBuf->values() : nullptr,
+						volume, panningBuf->values(), panningScale, frames );
 }
 
 
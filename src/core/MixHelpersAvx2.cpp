@@ -0,0 +1,106 @@
+/*
+ * MixHelpersAvx2.cpp - AVX2 implementation of the MixHelpers kernels
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+// This file is compiled with AVX2 enabled (see src/CMakeLists.txt) and must
+// only be called into after checking the CPU, see MixHelpers.cpp.
+
+#include "MixHelpersKernels.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace lmms::MixHelpers
+{
+
+namespace
+{
+
+struct Avx2
+{
+	using Reg = __m256;
+	using Mask = __m256;
+	static constexpr int Width = 8;
+
+	static Reg load( const float* p ) { return _mm256_loadu_ps( p ); }
+	static void store( float* p, Reg x ) { _mm256_storeu_ps( p, x ); }
+	static Reg set1( float x ) { return _mm256_set1_ps( x ); }
+	static Reg setPair( float l, float r ) { return _mm256_setr_ps( l, r, l, r, l, r, l, r ); }
+	static Reg loadDup( const float* p )
+	{
+		return _mm256_permutevar8x32_ps( _mm256_castps128_ps256( _mm_loadu_ps( p ) ),
+						_mm256_setr_epi32( 0, 0, 1, 1, 2, 2, 3, 3 ) );
+	}
+
+	static Reg zero() { return _mm256_setzero_ps(); }
+	static Reg add( Reg a, Reg b ) { return _mm256_add_ps( a, b ); }
+	static Reg mul( Reg a, Reg b ) { return _mm256_mul_ps( a, b ); }
+	static Reg min( Reg a, Reg b ) { return _mm256_min_ps( a, b ); }
+	static Reg max( Reg a, Reg b ) { return _mm256_max_ps( a, b ); }
+	static Reg abs( Reg x ) { return _mm256_and_ps( x, _mm256_castsi256_ps( _mm256_set1_epi32( 0x7fffffff ) ) ); }
+
+	static Mask badMask( Reg x )
+	{
+		const __m256i exponent = _mm256_set1_epi32( 0x7f800000 );
+		return _mm256_castsi256_ps( _mm256_cmpeq_epi32(
+			_mm256_and_si256( _mm256_castps_si256( x ), exponent ), exponent ) );
+	}
+	static Mask geMask( Reg a, Reg b ) { return _mm256_cmp_ps( a, b, _CMP_GE_OQ ); }
+	static Reg zeroIf( Mask m, Reg x ) { return _mm256_andnot_ps( m, x ); }
+	static Mask noMask() { return _mm256_setzero_ps(); }
+	static Mask orMask( Mask a, Mask b ) { return _mm256_or_ps( a, b ); }
+	static bool anyMask( Mask m ) { return _mm256_movemask_ps( m ) != 0; }
+} ;
+
+} // namespace
+
+} // namespace lmms::MixHelpers
+
+#include "MixHelpersSimd.h"
+
+namespace lmms::MixHelpers
+{
+
+static const Kernels s_avx2Kernels = makeKernels<Avx2>();
+
+const Kernels* avx2Kernels()
+{
+	return &s_avx2Kernels;
+}
+
+} // namespace lmms::MixHelpers
+
+#else
+
+namespace lmms::MixHelpers
+{
+
+const Kernels* avx2Kernels()
+{
+	return nullptr;
+}
+
+} // namespace lmms::MixHelpers
+
+#endif
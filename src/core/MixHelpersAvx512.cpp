@@ -0,0 +1,114 @@
+/*
+ * MixHelpersAvx512.cpp - AVX-512 implementation of the MixHelpers kernels
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+// This file is compiled with AVX-512F enabled (see src/CMakeLists.txt) and must
+// only be called into after checking the CPU, see MixHelpers.cpp.
+
+#include "MixHelpersKernels.h"
+
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+namespace lmms::MixHelpers
+{
+
+namespace
+{
+
+struct Avx512
+{
+	using Reg = __m512;
+	using Mask = __mmask16;
+	static constexpr int Width = 16;
+
+	static Reg load( const float* p ) { return _mm512_loadu_ps( p ); }
+	static void store( float* p, Reg x ) { _mm512_storeu_ps( p, x ); }
+	static Reg set1( float x ) { return _mm512_set1_ps( x ); }
+	static Reg setPair( float l, float r )
+	{
+		return _mm512_setr_ps( l, r, l, r, l, r, l, r, l, r, l, r, l, r, l, r );
+	}
+	static Reg loadDup( const float* p )
+	{
+		return _mm512_permutexvar_ps(
+			_mm512_setr_epi32( 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7 ),
+			_mm512_castps256_ps512( _mm256_loadu_ps( p ) ) );
+	}
+
+	static Reg zero() { return _mm512_setzero_ps(); }
+	static Reg add( Reg a, Reg b ) { return _mm512_add_ps( a, b ); }
+	static Reg mul( Reg a, Reg b ) { return _mm512_mul_ps( a, b ); }
+	static Reg min( Reg a, Reg b ) { return _mm512_min_ps( a, b ); }
+	static Reg max( Reg a, Reg b ) { return _mm512_max_ps( a, b ); }
+	static Reg abs( Reg x )
+	{
+		return _mm512_castsi512_ps( _mm512_and_si512( _mm512_castps_si512( x ),
+							_mm512_set1_epi32( 0x7fffffff ) ) );
+	}
+
+	static Mask badMask( Reg x )
+	{
+		const __m512i exponent = _mm512_set1_epi32( 0x7f800000 );
+		return _mm512_cmpeq_epi32_mask(
+			_mm512_and_si512( _mm512_castps_si512( x ), exponent ), exponent );
+	}
+	static Mask geMask( Reg a, Reg b ) { return _mm512_cmp_ps_mask( a, b, _CMP_GE_OQ ); }
+	static Reg zeroIf( Mask m, Reg x ) { return _mm512_maskz_mov_ps( static_cast<Mask>( ~m ), x ); }
+	static Mask noMask() { return 0; }
+	static Mask orMask( Mask a, Mask b ) { return static_cast<Mask>( a | b ); }
+	static bool anyMask( Mask m ) { return m != 0; }
+} ;
+
+} // namespace
+
+} // namespace lmms::MixHelpers
+
+#include "MixHelpersSimd.h"
+
+namespace lmms::MixHelpers
+{
+
+static const Kernels s_avx512Kernels = makeKernels<Avx512>();
+
+const Kernels* avx512Kernels()
+{
+	return &s_avx512Kernels;
+}
+
+} // namespace lmms::MixHelpers
+
+#else
+
+namespace lmms::MixHelpers
+{
+
+const Kernels* avx512Kernels()
+{
+	return nullptr;
+}
+
+} // namespace lmms::MixHelpers
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * MixHelpersSse2.cpp - SSE2 implementation of the MixHelpers kernels
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+// This file is compiled with SSE2 enabled (see src/CMakeLists.txt) and must
+// only be called into after checking the CPU, see MixHelpers.cpp.
+
+#include "MixHelpersKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+
+#include <emmintrin.h>
+
+namespace lmms::MixHelpers
+{
+
+namespace
+{
+
+struct Sse2
+{
+	using Reg = __m128;
+	using Mask = __m128;
+	static constexpr int Width = 4;
+
+	static Reg load( const float* p ) { return _mm_loadu_ps( p ); }
+	static void store( float* p, Reg x ) { _mm_storeu_ps( p, x ); }
+	static Reg set1( float x ) { return _mm_set1_ps( x ); }
+	static Reg setPair( float l, float r ) { return _mm_setr_ps( l, r, l, r ); }
+	static Reg loadDup( const float* p )
+	{
+		const Reg x = _mm_castsi128_ps( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( p ) ) );
+		return _mm_unpacklo_ps( x, x );
+	}
+
+	static Reg zero() { return _mm_setzero_ps(); }
+	static Reg add( Reg a, Reg b ) { return _mm_add_ps( a, b ); }
+	static Reg mul( Reg a, Reg b ) { return _mm_mul_ps( a, b ); }
+	static Reg min( Reg a, Reg b ) { return _mm_min_ps( a, b ); }
+	static Reg max( Reg a, Reg b ) { return _mm_max_ps( a, b ); }
+	static Reg abs( Reg x ) { return _mm_and_ps( x, _mm_castsi128_ps( _mm_set1_epi32( 0x7fffffff ) ) ); }
+
+	static Mask badMask( Reg x )
+	{
+		const __m128i exponent = _mm_set1_epi32( 0x7f800000 );
+		return _mm_castsi128_ps( _mm_cmpeq_epi32(
+			_mm_and_si128( _mm_castps_si128( x ), exponent ), exponent ) );
+	}
+	static Mask geMask( Reg a, Reg b ) { return _mm_cmpge_ps( a, b ); }
+	static Reg zeroIf( Mask m, Reg x ) { return _mm_andnot_ps( m, x ); }
+	static Mask noMask() { return _mm_setzero_ps(); }
+	static Mask orMask( Mask a, Mask b ) { return _mm_or_ps( a, b ); }
+	static bool anyMask( Mask m ) { return _mm_movemask_ps( m ) != 0; }
+} ;
+
+} // namespace
+
+} // namespace lmms::MixHelpers
+
+#include "MixHelpersSimd.h"
+
+namespace lmms::MixHelpers
+{
+
+static const Kernels s_sse2Kernels = makeKernels<Sse2>();
+
+const Kernels* sse2Kernels()
+{
+	return &s_sse2Kernels;
+}
+
+} // namespace lmms::MixHelpers
+
+#else
+
+namespace lmms::MixHelpers
+{
+
+const Kernels* sse2Kernels()
+{
+	return nullptr;
+}
+
+} // namespace lmms::MixHelpers
+
+#endif
@@ -22,10 +22,14 @@
  *
  */
 
+#include <algorithm>
+
 #include <QDomElement>
+#include <QHash>
 
 #include "AudioEngine.h"
 #include "AudioEngineWorkerThread.h"
+#include "AudioPort.h"
 #include "BufferManager.h"
 #include "Mixer.h"
 #include "MixHelpers.h"
@@ -71,9 +75,9 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 	m_name(),
 	m_lock(),
 	m_channelIndex( idx ),
-	m_queued( false ),
 	m_hasColor( false ),
-	m_dependenciesMet(0)
+	m_inputs(),
+	m_numInputs( 0 )
 {
 	BufferManager::clear( m_buffer, Engine::audioEngine()->framesPerPeriod() );
 }
@@ -87,27 +91,53 @@ MixerChannel::~MixerChannel()
 }
 
 
-inline void MixerChannel::processed()
+void MixerChannel::addInput( const sampleFrame * buf, int order )
 {
-	for( const MixerRoute * receiverRoute : m_sends )
+	// there's a slot for every audio port, see Mixer::reserveChannelInputs()
+	const int index = m_numInputs++;
+	Q_ASSERT( index < static_cast<int>( m_inputs.size() ) );
+	if( index < static_cast<int>( m_inputs.size() ) )
 	{
-		if( receiverRoute->receiver()->m_muted == false )
-		{
-			receiverRoute->receiver()->incrementDeps();
-		}
+		m_inputs[index] = { order, buf };
 	}
 }
 
-void MixerChannel::incrementDeps()
+
+
+
+void MixerChannel::reserveInputs( int count )
 {
-	int i = m_dependenciesMet++ + 1;
-	if( i >= m_receives.size() && ! m_queued )
+	if( count > static_cast<int>( m_inputs.size() ) )
 	{
-		m_queued = true;
-		AudioEngineWorkerThread::addJob( this );
+		m_inputs.resize( count );
 	}
 }
 
+
+
+
+void MixerChannel::mixInputs( fpp_t fpp )
+{
+	const int numInputs = qMin<int>( m_numInputs, m_inputs.size() );
+	if( numInputs == 0 )
+	{
+		return;
+	}
+
+	// sum up in a fixed order so the result does not depend on which
+	// worker thread finished first
+	std::sort( m_inputs.begin(), m_inputs.begin() + numInputs,
+		[]( const Input & a, const Input & b ) { return a.order < b.order; } );
+	for( int i = 0; i < numInputs; ++i )
+	{
+		MixHelpers::add( m_buffer, m_inputs[i].buffer, fpp );
+	}
+	m_hasInput = true;
+}
+
+
+
+
 void MixerChannel::unmuteForSolo()
 {
 	//TODO: Recursively activate every channel, this channel sends to
@@ -122,13 +152,17 @@ void MixerChannel::doProcessing()
 
 	if( m_muted == false )
 	{
+		mixInputs( fpp );
+
 		for( MixerRoute * senderRoute : m_receives )
 		{
 			MixerChannel * sender = senderRoute->sender();
 			FloatModel * sendModel = senderRoute->amount();
 			if( ! sendModel ) qFatal( "Error: no send model found from %d to %d", senderRoute->senderIndex(), m_channelIndex );
 
-			if( sender->m_hasInput || sender->m_stillRunning )
+			const bool senderActive = sender->m_hasInput || sender->m_stillRunning;
+			CompensationDelay & delay = senderRoute->compensationDelay();
+			if( senderActive || delay.hasTail() )
 			{
 				// figure out if we're getting sample-exact input
 				ValueBuffer * sendBuf = sendModel->valueBuffer();
@@ -137,6 +171,16 @@ void MixerChannel::doProcessing()
 				// mix it's output with this one's output
 				sampleFrame * ch_buf = sender->m_buffer;
 
+				// the sender's buffer may feed other routes, so delay a copy
+				sampleFrame * delayed = nullptr;
+				if( delay.delay() > 0 )
+				{
+					delayed = BufferManager::acquire();
+					std::copy_n( ch_buf, fpp, delayed );
+					delay.process( delayed, fpp, senderActive );
+					ch_buf = delayed;
+				}
+
 				// use sample-exact mixing if sample-exact values are available
 				if( ! volBuf && ! sendBuf ) // neither volume nor send has sample-exact data...
 				{
@@ -157,6 +201,10 @@ void MixerChannel::doProcessing()
 					const float v = sender->m_volumeModel.value();
 					MixHelpers::addSanitizedMultipliedByBuffer( m_buffer, ch_buf, v, sendBuf, fpp );
 				}
+				if( delayed )
+				{
+					BufferManager::release( delayed );
+				}
 				m_hasInput = true;
 			}
 		}
@@ -180,9 +228,6 @@ void MixerChannel::doProcessing()
 	{
 		m_peakLeft = m_peakRight = 0.0f;
 	}
-
-	// increment dependency counter of all receivers
-	processed();
 }
 
 
@@ -190,8 +235,12 @@ void MixerChannel::doProcessing()
 Mixer::Mixer() :
 	Model( nullptr ),
 	JournallingObject(),
-	m_mixerChannels()
+	m_mixerChannels(),
+	m_latencyChanged( false )
 {
+	connect( this, SIGNAL(latencyUpdateRequested()),
+			this, SLOT(applyLatencyUpdate()), Qt::QueuedConnection );
+
 	// create master channel
 	createChannel();
 	m_lastSoloed = -1;
@@ -219,7 +268,11 @@ int Mixer::createChannel()
 {
 	const int index = m_mixerChannels.size();
 	// create new channel
+	Engine::audioEngine()->requestChangeInModel();
 	m_mixerChannels.push_back( new MixerChannel( index, this ) );
+	m_mixerChannels.last()->reserveInputs( Engine::audioEngine()->audioPorts().size() );
+	rebuildMixLevels();
+	Engine::audioEngine()->doneChangeInModel();
 
 	// reset channel state
 	clearChannel( index );
@@ -345,6 +398,7 @@ void Mixer::deleteChannel( int index )
 	// actually delete the channel
 	m_mixerChannels.remove(index);
 	delete ch;
+	rebuildMixLevels();
 
 	for( int i = index; i < m_mixerChannels.size(); ++i )
 	{
@@ -479,6 +533,7 @@ MixerRoute * Mixer::createRoute( MixerChannel * from, MixerChannel * to, float a
 
 	// add us to mixer's list
 	Engine::mixer()->m_mixerRoutes.append( route );
+	rebuildMixLevels();
 	Engine::audioEngine()->doneChangeInModel();
 
 	return route;
@@ -514,6 +569,7 @@ void Mixer::deleteChannelSend( MixerRoute * route )
 	// remove us from mixer's list
 	Engine::mixer()->m_mixerRoutes.remove( Engine::mixer()->m_mixerRoutes.indexOf( route ) );
 	delete route;
+	rebuildMixLevels();
 	Engine::audioEngine()->doneChangeInModel();
 }
 
@@ -579,14 +635,11 @@ FloatModel * Mixer::channelSendModel( mix_ch_t fromChannel, mix_ch_t toChannel )
 
 
 
-void Mixer::mixToChannel( const sampleFrame * _buf, mix_ch_t _ch )
+void Mixer::mixToChannel( const sampleFrame * _buf, mix_ch_t _ch, int _order )
 {
 	if( m_mixerChannels[_ch]->m_muteModel.value() == false )
 	{
-		m_mixerChannels[_ch]->m_lock.lock();
-		MixHelpers::add( m_mixerChannels[_ch]->m_buffer, _buf, Engine::audioEngine()->framesPerPeriod() );
-		m_mixerChannels[_ch]->m_hasInput = true;
-		m_mixerChannels[_ch]->m_lock.unlock();
+		m_mixerChannels[_ch]->addInput( _buf, _order );
 	}
 }
 
@@ -597,6 +650,40 @@ void Mixer::prepareMasterMix()
 {
 	BufferManager::clear( m_mixerChannels[0]->m_buffer,
 					Engine::audioEngine()->framesPerPeriod() );
+
+	// when exporting, nothing needs to be realtime safe, but the delays
+	// should be right from the next period on
+	if( Engine::getSong()->isExporting() && m_latencyChanged.exchange( false ) )
+	{
+		updateLatencyCompensation();
+	}
+}
+
+
+
+
+void Mixer::requestLatencyUpdate()
+{
+	// only the first request schedules an update, later ones are covered
+	// by it until it has run
+	if( !m_latencyChanged.exchange( true ) )
+	{
+		emit latencyUpdateRequested();
+	}
+}
+
+
+
+
+void Mixer::applyLatencyUpdate()
+{
+	if( m_latencyChanged.exchange( false ) )
+	{
+		// the compensation delays get reallocated, so pause the audio thread
+		Engine::audioEngine()->requestChangeInModel();
+		updateLatencyCompensation();
+		Engine::audioEngine()->doneChangeInModel();
+	}
 }
 
 
@@ -605,64 +692,34 @@ void Mixer::masterMix( sampleFrame * _buf )
 {
 	const int fpp = Engine::audioEngine()->framesPerPeriod();
 
-	// add the channels that have no dependencies (no incoming senders, ie.
-	// no receives) to the jobqueue. The channels that have receives get
-	// added when their senders get processed, which is detected by
-	// dependency counting.
-	// also instantly add all muted channels as they don't need to care
-	// about their senders, and can just increment the deps of their
-	// recipients right away.
-	AudioEngineWorkerThread::resetJobQueue( AudioEngineWorkerThread::JobQueue::Dynamic );
 	for( MixerChannel * ch : m_mixerChannels )
 	{
 		ch->m_muted = ch->m_muteModel.value();
-		if( ch->m_muted ) // instantly "process" muted channels
-		{
-			ch->processed();
-			ch->done();
-		}
-		else if( ch->m_receives.size() == 0 )
-		{
-			ch->m_queued = true;
-			AudioEngineWorkerThread::addJob( ch );
-		}
 	}
-	while (m_mixerChannels[0]->state() != ThreadableJob::ProcessingState::Done)
+
+	// process the channels level by level. All senders of a channel are on
+	// lower levels, so by the time a level is queued its inputs are complete
+	// and its channels can run in parallel. Muted channels are processed as
+	// well, they just reset their peaks.
+	for( const QVector<MixerChannel *> & level : m_mixLevels )
 	{
-		bool found = false;
-		for( MixerChannel * ch : m_mixerChannels )
-		{
-			const auto s = ch->state();
-			if (s == ThreadableJob::ProcessingState::Queued
-				|| s == ThreadableJob::ProcessingState::InProgress)
-			{
-				found = true;
-				break;
-			}
-		}
-		if( !found )
-		{
-			break;
-		}
+		AudioEngineWorkerThread::fillJobQueue( level );
 		AudioEngineWorkerThread::startAndWaitForJobs();
 	}
 
-	// handle sample-exact data in master volume fader
+	// handle sample-exact data in master volume fader - applying the
+	// gain, sanitizing and mixing are done in one pass
 	ValueBuffer * volBuf = m_mixerChannels[0]->m_volumeModel.valueBuffer();
 
 	if( volBuf )
 	{
-		for( int f = 0; f < fpp; f++ )
-		{
-			m_mixerChannels[0]->m_buffer[f][0] *= volBuf->values()[f];
-			m_mixerChannels[0]->m_buffer[f][1] *= volBuf->values()[f];
-		}
+		MixHelpers::addSanitizedMultipliedByBuffer( _buf, m_mixerChannels[0]->m_buffer, 1.0f, volBuf, fpp );
+	}
+	else
+	{
+		MixHelpers::addSanitizedMultiplied( _buf, m_mixerChannels[0]->m_buffer,
+						m_mixerChannels[0]->m_volumeModel.value(), fpp );
 	}
-
-	const float v = volBuf
-		? 1.0f
-		: m_mixerChannels[0]->m_volumeModel.value();
-	MixHelpers::addSanitizedMultiplied( _buf, m_mixerChannels[0]->m_buffer, v, fpp );
 
 	// clear all channel buffers and
 	// reset channel process state
@@ -671,10 +728,116 @@ void Mixer::masterMix( sampleFrame * _buf )
 		BufferManager::clear( m_mixerChannels[i]->m_buffer,
 				Engine::audioEngine()->framesPerPeriod() );
 		m_mixerChannels[i]->reset();
-		m_mixerChannels[i]->m_queued = false;
 		// also reset hasInput
 		m_mixerChannels[i]->m_hasInput = false;
-		m_mixerChannels[i]->m_dependenciesMet = 0;
+		m_mixerChannels[i]->clearInputs();
+	}
+}
+
+
+
+
+void Mixer::reserveChannelInputs( int count )
+{
+	for( MixerChannel * ch : m_mixerChannels )
+	{
+		ch->reserveInputs( count );
+	}
+}
+
+
+
+
+void Mixer::rebuildMixLevels()
+{
+	// assign each channel the length of the longest send chain leading to
+	// it (Kahn's algorithm), so it ends up on a later level than all of its
+	// senders
+	QHash<const MixerChannel *, int> pendingReceives;
+	QHash<const MixerChannel *, int> levelOf;
+	QVector<MixerChannel *> ready;
+	for( MixerChannel * ch : m_mixerChannels )
+	{
+		pendingReceives[ch] = ch->m_receives.size();
+		levelOf[ch] = 0;
+		if( ch->m_receives.isEmpty() )
+		{
+			ready.push_back( ch );
+		}
+	}
+
+	m_mixLevels.clear();
+	while( ! ready.isEmpty() )
+	{
+		MixerChannel * ch = ready.takeLast();
+		const int level = levelOf[ch];
+		if( level >= m_mixLevels.size() )
+		{
+			m_mixLevels.resize( level + 1 );
+		}
+		m_mixLevels[level].push_back( ch );
+
+		for( const MixerRoute * route : ch->m_sends )
+		{
+			MixerChannel * receiver = route->receiver();
+			levelOf[receiver] = qMax( levelOf[receiver], level + 1 );
+			if( --pendingReceives[receiver] == 0 )
+			{
+				ready.push_back( receiver );
+			}
+		}
+	}
+
+	requestLatencyUpdate();
+}
+
+
+
+
+void Mixer::updateLatencyCompensation()
+{
+	const int count = m_mixerChannels.size();
+
+	// latency of the signals coming in from audio ports, per channel
+	std::vector<f_cnt_t> portLatency( count, 0 );
+	const QVector<AudioPort *> & ports = Engine::audioEngine()->audioPorts();
+	for( const AudioPort * port : ports )
+	{
+		const int ch = port->nextMixerChannel();
+		if( ch < count )
+		{
+			portLatency[ch] = qMax( portLatency[ch], port->latency() );
+		}
+	}
+
+	// walk the channels in dependency order, so all senders of a channel
+	// are known before the channel itself
+	std::vector<f_cnt_t> inputLatency( portLatency );
+	std::vector<f_cnt_t> outputLatency( count, 0 );
+	for( const QVector<MixerChannel *> & level : m_mixLevels )
+	{
+		for( MixerChannel * ch : level )
+		{
+			const int idx = ch->m_channelIndex;
+			for( const MixerRoute * route : ch->m_receives )
+			{
+				inputLatency[idx] = qMax( inputLatency[idx],
+						outputLatency[route->senderIndex()] );
+			}
+			outputLatency[idx] = inputLatency[idx] + ch->m_fxChain.latency();
+		}
+	}
+
+	for( AudioPort * port : ports )
+	{
+		const int ch = port->nextMixerChannel();
+		port->setCompensationDelay( ch < count
+				? inputLatency[ch] - port->latency() : 0 );
+	}
+	for( MixerRoute * route : m_mixerRoutes )
+	{
+		route->compensationDelay().setDelay(
+			inputLatency[route->receiverIndex()] - outputLatency[route->senderIndex()] );
 	}
 }
 
@@ -25,6 +25,12 @@
 
 #include "NotePlayHandle.h"
 
+#include <QSemaphore>
+#include <QThread>
+
+#include <atomic>
+#include <cstdint>
+
 #include "AudioEngine.h"
 #include "BasicFilters.h"
 #include "DetuningHelper.h"
@@ -596,28 +602,165 @@ void NotePlayHandle::resize( const bpm_t _new_tempo )
 }
 
 
-NotePlayHandle ** NotePlayHandleManager::s_available;
-QReadWriteLock NotePlayHandleManager::s_mutex;
-std::atomic_int NotePlayHandleManager::s_availableIndex;
-int NotePlayHandleManager::s_size;
+namespace
+{
 
+// handles are allocated in chunks, which are only freed by
+// NotePlayHandleManager::free()
+constexpr int ChunkSize = NPH_CACHE_INCREMENT;
+constexpr int MaxChunks = 1024;
+// the refill thread keeps at least this many handles in the shared list
+constexpr int LowWater = ChunkSize;
+// number of free handles each thread may keep for itself
+constexpr int LocalCacheSize = 32;
+constexpr std::uint32_t NoHandle = 0xffffffff;
+
+struct Chunk
+{
+	NotePlayHandle * handles;
+	//! the handle after this one in the free list
+	std::atomic_int next[ChunkSize];
+} ;
+
+std::atomic<Chunk *> s_chunks[MaxChunks];
+std::atomic_int s_chunkCount;
+// index of the first free handle in the lower half, a counter against the
+// ABA problem in the upper half
+std::atomic<std::uint64_t> s_freeList;
+std::atomic_int s_freeCount;
+std::atomic_int s_misses;
+std::atomic_bool s_alive;
+QSemaphore s_refillRequests;
+QThread * s_refillThread = nullptr;
+
+
+NotePlayHandle * handleAt( int index )
+{
+	return s_chunks[index / ChunkSize].load( std::memory_order_acquire )->handles + index % ChunkSize;
+}
 
-void NotePlayHandleManager::init()
+
+std::atomic_int & nextOf( int index )
 {
-	s_available = MM_ALLOC<NotePlayHandle*>( INITIAL_NPH_CACHE );
+	return s_chunks[index / ChunkSize].load( std::memory_order_acquire )->next[index % ChunkSize];
+}
 
-	NotePlayHandle * n = MM_ALLOC<NotePlayHandle>( INITIAL_NPH_CACHE );
 
-	for( int i=0; i < INITIAL_NPH_CACHE; ++i )
+void pushFree( int index )
+{
+	std::uint64_t top = s_freeList.load( std::memory_order_relaxed );
+	std::uint64_t newTop;
+	do
 	{
-		s_available[ i ] = n;
-		++n;
+		nextOf( index ).store( static_cast<int>( top & NoHandle ), std::memory_order_relaxed );
+		newTop = ( ( top >> 32 ) + 1 ) << 32 | static_cast<std::uint32_t>( index );
 	}
-	s_availableIndex = INITIAL_NPH_CACHE - 1;
-	s_size = INITIAL_NPH_CACHE;
+	while( !s_freeList.compare_exchange_weak( top, newTop,
+				std::memory_order_release, std::memory_order_relaxed ) );
+	s_freeCount.fetch_add( 1, std::memory_order_relaxed );
 }
 
 
+int popFree()
+{
+	std::uint64_t top = s_freeList.load( std::memory_order_acquire );
+	std::uint64_t newTop;
+	do
+	{
+		const std::uint32_t index = top & NoHandle;
+		if( index == NoHandle )
+		{
+			return -1;
+		}
+		// if another thread took this handle meanwhile, next may be
+		// outdated, but then the counter has changed and the exchange fails
+		const int next = nextOf( index ).load( std::memory_order_relaxed );
+		newTop = ( ( top >> 32 ) + 1 ) << 32 | static_cast<std::uint32_t>( next );
+	}
+	while( !s_freeList.compare_exchange_weak( top, newTop,
+				std::memory_order_acquire, std::memory_order_acquire ) );
+	s_freeCount.fetch_sub( 1, std::memory_order_relaxed );
+	return static_cast<int>( top & NoHandle );
+}
+
+
+bool addChunk()
+{
+	const int n = s_chunkCount.fetch_add( 1 );
+	if( n >= MaxChunks )
+	{
+		s_chunkCount.fetch_sub( 1 );
+		return false;
+	}
+
+	Chunk * chunk = new Chunk;
+	chunk->handles = MM_ALLOC<NotePlayHandle>( ChunkSize );
+	s_chunks[n].store( chunk, std::memory_order_release );
+	for( int i = 0; i < ChunkSize; ++i )
+	{
+		pushFree( n * ChunkSize + i );
+	}
+	return true;
+}
+
+
+struct LocalCache
+{
+	int indices[LocalCacheSize];
+	int count = 0;
+
+	~LocalCache()
+	{
+		// hand the handles of a finishing thread to the others
+		if( s_alive )
+		{
+			while( count > 0 )
+			{
+				pushFree( indices[--count] );
+			}
+		}
+	}
+} ;
+
+thread_local LocalCache t_cache;
+
+
+class RefillThread : public QThread
+{
+	void run() override
+	{
+		while( true )
+		{
+			s_refillRequests.acquire();
+			if( !s_alive )
+			{
+				return;
+			}
+			while( s_freeCount.load( std::memory_order_relaxed ) < LowWater && addChunk() )
+			{
+			}
+		}
+	}
+} ;
+
+} // namespace
+
+
+
+
+void NotePlayHandleManager::init()
+{
+	s_freeList = NoHandle;
+	s_alive = true;
+	reserve( INITIAL_NPH_CACHE );
+
+	s_refillThread = new RefillThread;
+	s_refillThread->start( QThread::LowPriority );
+}
+
+
+
+
 NotePlayHandle * NotePlayHandleManager::acquire( InstrumentTrack* instrumentTrack,
 				const f_cnt_t offset,
 				const f_cnt_t frames,
@@ -626,45 +769,111 @@ NotePlayHandle * NotePlayHandleManager::acquire( InstrumentTrack* instrumentTrac
 				int midiEventChannel,
 				NotePlayHandle::Origin origin )
 {
-	// TODO: use some lockless data structures
-	s_mutex.lockForWrite();
-	if (s_availableIndex < 0) { extend(NPH_CACHE_INCREMENT); }
-	NotePlayHandle * nph = s_available[s_availableIndex--];
-	s_mutex.unlock();
+	LocalCache & cache = t_cache;
+	while( cache.count == 0 )
+	{
+		// take several at once, so the next notes don't need the shared list
+		while( cache.count < LocalCacheSize / 2 )
+		{
+			const int index = popFree();
+			if( index < 0 )
+			{
+				break;
+			}
+			cache.indices[cache.count++] = index;
+		}
+
+		if( s_freeCount.load( std::memory_order_relaxed ) < LowWater )
+		{
+			s_refillRequests.release();
+		}
+
+		if( cache.count == 0 )
+		{
+			// the refill thread didn't keep up, so allocate right here
+			s_misses.fetch_add( 1, std::memory_order_relaxed );
+			if( !addChunk() )
+			{
+				qFatal( "NotePlayHandleManager: too many notes playing" );
+			}
+		}
+	}
 
+	const int index = cache.indices[--cache.count];
+	NotePlayHandle * nph = handleAt( index );
 	new( (void*)nph ) NotePlayHandle( instrumentTrack, offset, frames, noteToPlay, parent, midiEventChannel, origin );
+	nph->m_poolIndex = index;
 	return nph;
 }
 
 
+
+
 void NotePlayHandleManager::release( NotePlayHandle * nph )
 {
+	const int index = nph->m_poolIndex;
 	nph->NotePlayHandle::~NotePlayHandle();
-	s_mutex.lockForRead();
-	s_available[++s_availableIndex] = nph;
-	s_mutex.unlock();
+
+	LocalCache & cache = t_cache;
+	if( cache.count == LocalCacheSize )
+	{
+		// only give half of them away, so a thread which alternately
+		// acquires and releases doesn't hit the shared list every time
+		while( cache.count > LocalCacheSize / 2 )
+		{
+			pushFree( cache.indices[--cache.count] );
+		}
+	}
+	cache.indices[cache.count++] = index;
 }
 
 
-void NotePlayHandleManager::extend( int c )
-{
-	s_size += c;
-	NotePlayHandle ** tmp = MM_ALLOC<NotePlayHandle*>( s_size );
-	MM_FREE( s_available );
-	s_available = tmp;
 
-	NotePlayHandle * n = MM_ALLOC<NotePlayHandle>( c );
 
-	for( int i=0; i < c; ++i )
+void NotePlayHandleManager::reserve( int count )
+{
+	while( size() < count && addChunk() )
 	{
-		s_available[++s_availableIndex] = n;
-		++n;
 	}
 }
 
+
+
+
 void NotePlayHandleManager::free()
 {
-	MM_FREE(s_available);
+	s_alive = false;
+	s_refillRequests.release();
+	s_refillThread->wait();
+	delete s_refillThread;
+	s_refillThread = nullptr;
+
+	const int chunks = s_chunkCount.exchange( 0 );
+	for( int i = 0; i < chunks; ++i )
+	{
+		Chunk * chunk = s_chunks[i].exchange( nullptr );
+		MM_FREE( chunk->handles );
+		delete chunk;
+	}
+	s_freeList = NoHandle;
+	s_freeCount = 0;
+	t_cache.count = 0;
+}
+
+
+
+
+int NotePlayHandleManager::size()
+{
+	return qMin( s_chunkCount.load(), MaxChunks ) * ChunkSize;
+}
+
+
+
+
+int NotePlayHandleManager::misses()
+{
+	return s_misses.load( std::memory_order_relaxed );
 }
 
 
@@ -25,7 +25,14 @@
 
 #include "Oscillator.h"
 
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #if !defined(__MINGW32__) && !defined(__MINGW64__)
 	#include <thread>
 #endif
@@ -34,6 +41,7 @@
 #include "Engine.h"
 #include "AudioEngine.h"
 #include "AutomatableModel.h"
+#include "ConfigManager.h"
 #include "fftw3.h"
 #include "fft_helpers.h"
 
@@ -42,10 +50,91 @@ namespace lmms
 {
 
 
+namespace
+{
+
+// Increase whenever the generated wavetables change
+constexpr quint32 WaveTableCacheVersion = 1;
+constexpr char WaveTableCacheMagic[8] = { 'L', 'M', 'M', 'S', 'W', 'T', 'C', '\0' };
+
+struct WaveTableCacheHeader
+{
+	char magic[8];
+	quint32 version;
+	// written as 0x01020304 to detect files of another byte order
+	quint32 byteOrder;
+	quint32 shapes;
+	quint32 tables;
+	quint32 length;
+	quint32 maxFreq;
+	quint64 checksum;
+	// keeps the tables after the header aligned
+	quint32 reserved[2];
+} ;
+
+static_assert( sizeof( WaveTableCacheHeader ) % 16 == 0, "the tables must stay aligned" );
+
+constexpr qint64 WaveTablesSize = sizeof( sample_t ) * ( Oscillator::NumWaveShapeTables *
+		OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT * OscillatorConstants::WAVETABLE_LENGTH );
+
+// keeps the cache file mapped for as long as the tables are used
+QFile * s_waveTableCacheFile = nullptr;
+std::unique_ptr<sample_t[]> s_generatedWaveTables;
+
+
+QString waveTableCachePath()
+{
+	return ConfigManager::inst()->cacheDir() + "wavetables.bin";
+}
+
+
+QString fftwWisdomPath()
+{
+	return ConfigManager::inst()->cacheDir() + "fftwf-wisdom.txt";
+}
+
+
+// FNV-1a over 32 bit words
+quint64 waveTableChecksum( const sample_t * tables )
+{
+	const quint32 * words = reinterpret_cast<const quint32 *>( tables );
+	quint64 hash = 14695981039346656037ULL;
+	for( qint64 i = 0; i < WaveTablesSize / 4; ++i )
+	{
+		hash = ( hash ^ words[i] ) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+
+WaveTableCacheHeader waveTableCacheHeader()
+{
+	WaveTableCacheHeader header{};
+	std::memcpy( header.magic, WaveTableCacheMagic, sizeof( header.magic ) );
+	header.version = WaveTableCacheVersion;
+	header.byteOrder = 0x01020304;
+	header.shapes = Oscillator::NumWaveShapeTables;
+	header.tables = OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT;
+	header.length = OscillatorConstants::WAVETABLE_LENGTH;
+	header.maxFreq = OscillatorConstants::MAX_FREQ;
+	return header;
+}
+
+} // namespace
+
+
+
+
 void Oscillator::waveTableInit()
 {
 	createFFTPlans();
-	generateWaveTables();
+	// Building the band-limited tables takes a while, so they are kept in a
+	// cache file which is only regenerated if it doesn't match anymore
+	if( !loadWaveTableCache() )
+	{
+		generateWaveTables();
+		saveWaveTableCache();
+	}
 	// The oscillator FFT plans remain throughout the application lifecycle
 	// due to being expensive to create, and being used whenever a userwave form is changed
 	// deleted in main.cpp main()
@@ -198,10 +287,9 @@ void Oscillator::generateAntiAliasUserWaveTable(SampleBuffer *sampleBuffer)
 
 
 
-sample_t Oscillator::s_waveTables
-	[Oscillator::WaveShapes::NumWaveShapeTables]
+sample_t (*Oscillator::s_waveTables)
 	[OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT]
-	[OscillatorConstants::WAVETABLE_LENGTH];
+	[OscillatorConstants::WAVETABLE_LENGTH] = nullptr;
 fftwf_plan Oscillator::s_fftPlan;
 fftwf_plan Oscillator::s_ifftPlan;
 fftwf_complex * Oscillator::s_specBuf;
@@ -211,9 +299,31 @@ float Oscillator::s_sampleBuffer[OscillatorConstants::WAVETABLE_LENGTH];
 
 void Oscillator::createFFTPlans()
 {
+	// FFTW_MEASURE tries out many algorithms, remember the result
+	QFile wisdomFile( fftwWisdomPath() );
+	bool haveWisdom = false;
+	if( wisdomFile.open( QIODevice::ReadOnly ) )
+	{
+		haveWisdom = fftwf_import_wisdom_from_string( wisdomFile.readAll().constData() ) != 0;
+		wisdomFile.close();
+	}
+
 	Oscillator::s_specBuf = ( fftwf_complex * ) fftwf_malloc( ( OscillatorConstants::WAVETABLE_LENGTH * 2 + 1 ) * sizeof( fftwf_complex ) );
 	Oscillator::s_fftPlan = fftwf_plan_dft_r2c_1d(OscillatorConstants::WAVETABLE_LENGTH, s_sampleBuffer, s_specBuf, FFTW_MEASURE );
 	Oscillator::s_ifftPlan = fftwf_plan_dft_c2r_1d(OscillatorConstants::WAVETABLE_LENGTH, s_specBuf, s_sampleBuffer, FFTW_MEASURE);
+
+	if( !haveWisdom && QDir().mkpath( ConfigManager::inst()->cacheDir() ) )
+	{
+		char * wisdom = fftwf_export_wisdom_to_string();
+		QSaveFile file( fftwWisdomPath() );
+		if( wisdom && file.open( QIODevice::WriteOnly ) )
+		{
+			file.write( wisdom );
+			file.commit();
+		}
+		free( wisdom );
+	}
+
 	// initialize s_specBuf content to zero, since the values are used in a condition inside generateFromFFT()
 	for (int i = 0; i < OscillatorConstants::WAVETABLE_LENGTH * 2 + 1; i++)
 	{
@@ -229,8 +339,63 @@ void Oscillator::destroyFFTPlans()
 	fftwf_free(s_specBuf);
 }
 
+bool Oscillator::loadWaveTableCache()
+{
+	auto file = std::make_unique<QFile>( waveTableCachePath() );
+	if( !file->open( QIODevice::ReadOnly ) ||
+		file->size() != static_cast<qint64>( sizeof( WaveTableCacheHeader ) ) + WaveTablesSize )
+	{
+		return false;
+	}
+
+	uchar * data = file->map( 0, file->size() );
+	if( data == nullptr )
+	{
+		return false;
+	}
+
+	WaveTableCacheHeader header;
+	std::memcpy( &header, data, sizeof( header ) );
+	const sample_t * tables = reinterpret_cast<const sample_t *>( data + sizeof( header ) );
+	WaveTableCacheHeader expected = waveTableCacheHeader();
+	expected.checksum = header.checksum;
+	if( std::memcmp( &header, &expected, sizeof( header ) ) != 0 ||
+		waveTableChecksum( tables ) != header.checksum )
+	{
+		return false;
+	}
+
+	// the mapping is read-only, nothing writes to these tables after startup
+	s_waveTables = reinterpret_cast<decltype( s_waveTables )>( const_cast<sample_t *>( tables ) );
+	s_waveTableCacheFile = file.release();
+	return true;
+}
+
+void Oscillator::saveWaveTableCache()
+{
+	if( !QDir().mkpath( ConfigManager::inst()->cacheDir() ) )
+	{
+		return;
+	}
+
+	WaveTableCacheHeader header = waveTableCacheHeader();
+	header.checksum = waveTableChecksum( s_waveTables[0][0] );
+
+	// other processes might write it at the same time, so replace it at once
+	QSaveFile file( waveTableCachePath() );
+	if( file.open( QIODevice::WriteOnly ) )
+	{
+		file.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+		file.write( reinterpret_cast<const char *>( s_waveTables[0][0] ), WaveTablesSize );
+		file.commit();
+	}
+}
+
 void Oscillator::generateWaveTables()
 {
+	s_generatedWaveTables.reset( new sample_t[WaveTablesSize / sizeof( sample_t )]() );
+	s_waveTables = reinterpret_cast<decltype( s_waveTables )>( s_generatedWaveTables.get() );
+
 	// Generate tables for simple shaped (constructed by summing sine waves).
 	// Start from the table that contains the least number of bands, and re-use each table in the following
 	// iteration, adding more bands in each step and avoiding repeated computation of earlier bands.
@@ -567,6 +732,30 @@ float Oscillator::syncInit( sampleFrame * _ab, const fpp_t _frames,
 
 
 
+template<Oscillator::WaveShapes W, typename PhaseFn, typename StoreFn>
+inline void Oscillator::renderBlocks( const fpp_t _frames, PhaseFn nextPhase, StoreFn store )
+{
+	float phases[BlockSize];
+	sample_t samples[BlockSize];
+
+	for( fpp_t start = 0; start < _frames; start += BlockSize )
+	{
+		const int count = std::min<int>( BlockSize, _frames - start );
+		for( int i = 0; i < count; ++i )
+		{
+			phases[i] = nextPhase( start + i );
+		}
+		getSamples<W>( phases, samples, count );
+		for( int i = 0; i < count; ++i )
+		{
+			store( start + i, samples[i] );
+		}
+	}
+}
+
+
+
+
 // if we have no sub-osc, we can't do any modulation... just get our samples
 template<Oscillator::WaveShapes W>
 void Oscillator::updateNoSub( sampleFrame * _ab, const fpp_t _frames,
@@ -574,12 +763,17 @@ void Oscillator::updateNoSub( sampleFrame * _ab, const fpp_t _frames,
 {
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
-
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
+	const float volume = m_volume;
+
+	renderBlocks<W>( _frames,
+		[&]( fpp_t ) {
+			const float phase = m_phase;
+			m_phase += osc_coeff;
+			return phase;
+		},
+		[&]( fpp_t frame, sample_t sample ) {
+			_ab[frame][_chnl] = sample * volume;
+		} );
 }
 
 
@@ -593,14 +787,17 @@ void Oscillator::updatePM( sampleFrame * _ab, const fpp_t _frames,
 	m_subOsc->update( _ab, _frames, _chnl, true );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
-
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		_ab[frame][_chnl] = getSample<W>( m_phase +
-					_ab[frame][_chnl] )
-							* m_volume;
-		m_phase += osc_coeff;
-	}
+	const float volume = m_volume;
+
+	renderBlocks<W>( _frames,
+		[&]( fpp_t frame ) {
+			const float phase = m_phase + _ab[frame][_chnl];
+			m_phase += osc_coeff;
+			return phase;
+		},
+		[&]( fpp_t frame, sample_t sample ) {
+			_ab[frame][_chnl] = sample * volume;
+		} );
 }
 
 
@@ -614,12 +811,17 @@ void Oscillator::updateAM( sampleFrame * _ab, const fpp_t _frames,
 	m_subOsc->update( _ab, _frames, _chnl, false );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
-
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		_ab[frame][_chnl] *= getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
+	const float volume = m_volume;
+
+	renderBlocks<W>( _frames,
+		[&]( fpp_t ) {
+			const float phase = m_phase;
+			m_phase += osc_coeff;
+			return phase;
+		},
+		[&]( fpp_t frame, sample_t sample ) {
+			_ab[frame][_chnl] *= sample * volume;
+		} );
 }
 
 
@@ -633,12 +835,17 @@ void Oscillator::updateMix( sampleFrame * _ab, const fpp_t _frames,
 	m_subOsc->update( _ab, _frames, _chnl, false );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
-
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		_ab[frame][_chnl] += getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
+	const float volume = m_volume;
+
+	renderBlocks<W>( _frames,
+		[&]( fpp_t ) {
+			const float phase = m_phase;
+			m_phase += osc_coeff;
+			return phase;
+		},
+		[&]( fpp_t frame, sample_t sample ) {
+			_ab[frame][_chnl] += sample * volume;
+		} );
 }
 
 
@@ -653,16 +860,21 @@ void Oscillator::updateSync( sampleFrame * _ab, const fpp_t _frames,
 	const float sub_osc_coeff = m_subOsc->syncInit( _ab, _frames, _chnl );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
+	const float volume = m_volume;
 
-	for( fpp_t frame = 0; frame < _frames ; ++frame )
-	{
-		if( m_subOsc->syncOk( sub_osc_coeff ) )
-		{
-			m_phase = m_phaseOffset;
-		}
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
+	renderBlocks<W>( _frames,
+		[&]( fpp_t ) {
+			if( m_subOsc->syncOk( sub_osc_coeff ) )
+			{
+				m_phase = m_phaseOffset;
+			}
+			const float phase = m_phase;
+			m_phase += osc_coeff;
+			return phase;
+		},
+		[&]( fpp_t frame, sample_t sample ) {
+			_ab[frame][_chnl] = sample * volume;
+		} );
 }
 
 
@@ -677,30 +889,56 @@ void Oscillator::updateFM( sampleFrame * _ab, const fpp_t _frames,
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
 	const float sampleRateCorrection = 44100.0f / Engine::audioEngine()->processingSampleRate();
+	const float volume = m_volume;
+
+	renderBlocks<W>( _frames,
+		[&]( fpp_t frame ) {
+			m_phase += _ab[frame][_chnl] * sampleRateCorrection;
+			const float phase = m_phase;
+			m_phase += osc_coeff;
+			return phase;
+		},
+		[&]( fpp_t frame, sample_t sample ) {
+			_ab[frame][_chnl] = sample * volume;
+		} );
+}
+
 
-	for( fpp_t frame = 0; frame < _frames; ++frame )
+
+
+inline void Oscillator::wtSamples( const sample_t * table, const float * phases,
+						sample_t * samples, const int count )
+{
+	for( int i = 0; i < count; ++i )
 	{
-		m_phase += _ab[frame][_chnl] * sampleRateCorrection;
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
+		const float frame = phases[i] * OscillatorConstants::WAVETABLE_LENGTH;
+		f_cnt_t f1 = static_cast<f_cnt_t>( frame ) % OscillatorConstants::WAVETABLE_LENGTH;
+		if( f1 < 0 )
+		{
+			f1 += OscillatorConstants::WAVETABLE_LENGTH;
+		}
+		const f_cnt_t f2 = f1 < OscillatorConstants::WAVETABLE_LENGTH - 1 ? f1 + 1 : 0;
+		samples[i] = linearInterpolate( table[f1], table[f2], fraction( frame ) );
 	}
 }
 
 
 
 
-template<>
-inline sample_t Oscillator::getSample<Oscillator::SineWave>(const float sample)
+template<sample_t SHAPE( const float )>
+inline void Oscillator::bandLimitedSamples( const int table, const float * phases,
+						sample_t * samples, const int count )
 {
-	const float current_freq = m_freq * m_detuning_div_samplerate * Engine::audioEngine()->processingSampleRate();
-
-	if (!m_useWaveTable || current_freq < OscillatorConstants::MAX_FREQ)
+	if( m_useWaveTable && !m_isModulator )
 	{
-		return sinSample(sample);
+		wtSamples( s_waveTables[table][waveTableBand()], phases, samples, count );
 	}
 	else
 	{
-		return 0;
+		for( int i = 0; i < count; ++i )
+		{
+			samples[i] = SHAPE( phases[i] );
+		}
 	}
 }
 
@@ -708,16 +946,20 @@ inline sample_t Oscillator::getSample<Oscillator::SineWave>(const float sample)
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::TriangleWave>(
-		const float _sample )
+inline void Oscillator::getSamples<Oscillator::SineWave>( const float * phases,
+						sample_t * samples, const int count )
 {
-	if (m_useWaveTable && !m_isModulator)
+	const float current_freq = m_freq * m_detuning_div_samplerate * Engine::audioEngine()->processingSampleRate();
+
+	if( m_useWaveTable && current_freq >= OscillatorConstants::MAX_FREQ )
 	{
-		return wtSample(s_waveTables[WaveShapes::TriangleWave - FirstWaveShapeTable],_sample);
+		std::fill( samples, samples + count, 0.0f );
+		return;
 	}
-	else
+
+	for( int i = 0; i < count; ++i )
 	{
-		return triangleSample(_sample);
+		samples[i] = sinSample( phases[i] );
 	}
 }
 
@@ -725,94 +967,83 @@ inline sample_t Oscillator::getSample<Oscillator::TriangleWave>(
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::SawWave>(
-		const float _sample )
+inline void Oscillator::getSamples<Oscillator::TriangleWave>( const float * phases,
+						sample_t * samples, const int count )
 {
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[WaveShapes::SawWave - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return sawSample(_sample);
-	}
+	bandLimitedSamples<triangleSample>( TriangleWave - FirstWaveShapeTable, phases, samples, count );
 }
 
 
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::SquareWave>(
-		const float _sample )
+inline void Oscillator::getSamples<Oscillator::SawWave>( const float * phases,
+						sample_t * samples, const int count )
 {
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[WaveShapes::SquareWave - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return squareSample(_sample);
-	}
+	bandLimitedSamples<sawSample>( SawWave - FirstWaveShapeTable, phases, samples, count );
 }
 
 
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::MoogSawWave>(
-							const float _sample )
+inline void Oscillator::getSamples<Oscillator::SquareWave>( const float * phases,
+						sample_t * samples, const int count )
 {
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[WaveShapes::MoogSawWave - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return moogSawSample(_sample);
-	}
+	bandLimitedSamples<squareSample>( SquareWave - FirstWaveShapeTable, phases, samples, count );
 }
 
 
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::ExponentialWave>(
-							const float _sample )
+inline void Oscillator::getSamples<Oscillator::MoogSawWave>( const float * phases,
+						sample_t * samples, const int count )
 {
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[WaveShapes::ExponentialWave - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return expSample(_sample);
-	}
+	bandLimitedSamples<moogSawSample>( MoogSawWave - FirstWaveShapeTable, phases, samples, count );
 }
 
 
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::WhiteNoise>(
-							const float _sample )
+inline void Oscillator::getSamples<Oscillator::ExponentialWave>( const float * phases,
+						sample_t * samples, const int count )
 {
-	return( noiseSample( _sample ) );
+	bandLimitedSamples<expSample>( ExponentialWave - FirstWaveShapeTable, phases, samples, count );
 }
 
 
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::UserDefinedWave>(
-							const float _sample )
+inline void Oscillator::getSamples<Oscillator::WhiteNoise>( const float * phases,
+						sample_t * samples, const int count )
 {
-	if (m_useWaveTable && !m_isModulator)
+	for( int i = 0; i < count; ++i )
 	{
-		return wtSample(m_userWave->m_userAntiAliasWaveTable, _sample);
+		samples[i] = noiseSample( phases[i] );
+	}
+}
+
+
+
+
+template<>
+inline void Oscillator::getSamples<Oscillator::UserDefinedWave>( const float * phases,
+						sample_t * samples, const int count )
+{
+	if( m_useWaveTable && !m_isModulator )
+	{
+		wtSamples( ( *m_userWave->m_userAntiAliasWaveTable )[waveTableBand()].data(),
+							phases, samples, count );
 	}
 	else
 	{
-		return userWaveSample(_sample);
+		for( int i = 0; i < count; ++i )
+		{
+			samples[i] = userWaveSample( phases[i] );
+		}
 	}
 }
 
@@ -237,7 +237,7 @@ void PatternStore::createClipsForPattern(int pattern)
 	}
 }
 
-AutomatedValueMap PatternStore::automatedValuesAt(TimePos time, int clipNum) const
+void PatternStore::visitAutomation(TimePos time, int clipNum, const AutomationVisitor& visit) const
 {
 	Q_ASSERT(clipNum >= 0);
 	Q_ASSERT(time.getTicks() >= 0);
@@ -249,7 +249,7 @@ AutomatedValueMap PatternStore::automatedValuesAt(TimePos time, int clipNum) con
 		time = lengthTicks;
 	}
 
-	return TrackContainer::automatedValuesAt(time + (TimePos::ticksPerBar() * clipNum), clipNum);
+	TrackContainer::visitAutomation(time + (TimePos::ticksPerBar() * clipNum), clipNum, visit);
 }
 
 
@@ -37,7 +37,7 @@ PlayHandle::PlayHandle(const Type type, f_cnt_t offset) :
 		m_type(type),
 		m_offset(offset),
 		m_affinity(QThread::currentThread()),
-		m_playHandleBuffer(BufferManager::acquire()),
+		m_playHandleBuffer(nullptr),
 		m_bufferReleased(true),
 		m_usesBuffer(true)
 {
@@ -46,7 +46,6 @@ PlayHandle::PlayHandle(const Type type, f_cnt_t offset) :
 
 PlayHandle::~PlayHandle()
 {
-	BufferManager::release(m_playHandleBuffer);
 }
 
 
@@ -54,6 +53,9 @@ void PlayHandle::doProcessing()
 {
 	if( m_usesBuffer )
 	{
+		// the audio port mixes the buffer within this period, so it only
+		// has to live that long
+		m_playHandleBuffer = BufferManager::acquireForPeriod();
 		m_bufferReleased = false;
 		BufferManager::clear(m_playHandleBuffer, Engine::audioEngine()->framesPerPeriod());
 		play( buffer() );
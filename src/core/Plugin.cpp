@@ -32,6 +32,7 @@
 #include "embed.h"
 #include "Engine.h"
 #include "GuiApplication.h"
+#include "Mixer.h"
 #include "DummyPlugin.h"
 #include "AutomatableModel.h"
 #include "Song.h"
@@ -63,7 +64,8 @@ Plugin::Plugin(const Descriptor * descriptor, Model * parent, const
 	Model(parent),
 	JournallingObject(),
 	m_descriptor(descriptor),
-	m_key(key ? *key : Descriptor::SubPluginFeatures::Key(m_descriptor))
+	m_key(key ? *key : Descriptor::SubPluginFeatures::Key(m_descriptor)),
+	m_latency(0)
 {
 	if( m_descriptor == nullptr )
 	{
@@ -74,6 +76,28 @@ Plugin::Plugin(const Descriptor * descriptor, Model * parent, const
 
 
 
+void Plugin::setLatency(f_cnt_t frames)
+{
+	if (m_latency.exchange(frames) != frames)
+	{
+		latencyChanged();
+	}
+}
+
+
+
+
+void Plugin::latencyChanged()
+{
+	if (Engine::mixer())
+	{
+		Engine::mixer()->requestLatencyUpdate();
+	}
+}
+
+
+
+
 template<class T>
 T use_this_or(T this_param, T or_param)
 {
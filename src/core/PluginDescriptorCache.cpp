@@ -0,0 +1,167 @@
+/*
+ * PluginDescriptorCache.cpp - remembers what was found out about plugin files
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PluginDescriptorCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include "ConfigManager.h"
+#include "lmmsversion.h"
+
+
+namespace lmms
+{
+
+
+namespace
+{
+
+constexpr quint32 CacheMagic = 0x4c504443; // "LPDC"
+// Increase whenever the layout of the file changes
+constexpr quint32 CacheFormat = 1;
+
+}
+
+
+
+
+PluginDescriptorCache::PluginDescriptorCache( const QString & name ) :
+	m_path( ConfigManager::inst()->cacheDir() + name ),
+	m_changed( false )
+{
+	load();
+}
+
+
+
+
+PluginDescriptorCache::~PluginDescriptorCache()
+{
+	save();
+}
+
+
+
+
+QByteArray PluginDescriptorCache::find( const QFileInfo & file )
+{
+	const QString path = file.absoluteFilePath();
+	const auto it = m_entries.constFind( path );
+	if( it == m_entries.constEnd() || it->size != file.size() ||
+		it->modified != file.lastModified().toMSecsSinceEpoch() )
+	{
+		return QByteArray();
+	}
+
+	m_used.insert( path, *it );
+	return it->data;
+}
+
+
+
+
+void PluginDescriptorCache::insert( const QFileInfo & file, const QByteArray & data )
+{
+	const Entry entry = { file.size(), file.lastModified().toMSecsSinceEpoch(), data };
+	m_entries.insert( file.absoluteFilePath(), entry );
+	m_used.insert( file.absoluteFilePath(), entry );
+	m_changed = true;
+}
+
+
+
+
+void PluginDescriptorCache::save()
+{
+	// also rewrite the file if some entries weren't used, to drop them
+	if( !m_changed && m_used.size() == m_entries.size() )
+	{
+		return;
+	}
+
+	QSaveFile file( m_path );
+	if( !QDir().mkpath( QFileInfo( m_path ).absolutePath() ) ||
+		!file.open( QIODevice::WriteOnly ) )
+	{
+		return;
+	}
+
+	QDataStream stream( &file );
+	stream.setVersion( QDataStream::Qt_5_6 );
+	stream << CacheMagic << CacheFormat << QString( LMMS_VERSION )
+		<< static_cast<quint32>( m_used.size() );
+	for( auto it = m_used.constBegin(); it != m_used.constEnd(); ++it )
+	{
+		stream << it.key() << it->size << it->modified << it->data;
+	}
+
+	if( file.commit() )
+	{
+		m_entries = m_used;
+		m_changed = false;
+	}
+}
+
+
+
+
+void PluginDescriptorCache::load()
+{
+	QFile file( m_path );
+	if( !file.open( QIODevice::ReadOnly ) )
+	{
+		return;
+	}
+
+	QDataStream stream( &file );
+	stream.setVersion( QDataStream::Qt_5_6 );
+	quint32 magic = 0, format = 0, count = 0;
+	QString version;
+	stream >> magic >> format >> version >> count;
+	if( magic != CacheMagic || format != CacheFormat || version != LMMS_VERSION )
+	{
+		// what LMMS supports might have changed, e.g. LV2 features
+		return;
+	}
+
+	for( quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i )
+	{
+		QString path;
+		Entry entry;
+		stream >> path >> entry.size >> entry.modified >> entry.data;
+		m_entries.insert( path, entry );
+	}
+
+	if( stream.status() != QDataStream::Ok )
+	{
+		m_entries.clear();
+	}
+}
+
+
+} // namespace lmms
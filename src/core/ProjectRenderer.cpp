@@ -23,6 +23,7 @@
  */
 
 
+#include <QElapsedTimer>
 #include <QFile>
 
 #include "ProjectRenderer.h"
@@ -86,7 +87,9 @@ ProjectRenderer::ProjectRenderer( const AudioEngine::qualitySettings & qualitySe
 	m_fileDev( nullptr ),
 	m_qualitySettings( qualitySettings ),
 	m_progress( 0 ),
-	m_abort( false )
+	m_abort( false ),
+	m_renderedSeconds( 0 ),
+	m_renderTime( 0 )
 {
 	AudioFileDeviceInstantiaton audioEncoderFactory = fileEncodeDevices[exportFileFormat].m_getDevInst;
 
@@ -172,6 +175,9 @@ void ProjectRenderer::run()
 #endif
 
 	PerfLogTimer perfLog("Project Render");
+	QElapsedTimer renderTimer;
+	renderTimer.start();
+	std::int64_t renderedFrames = 0;
 
 	Engine::getSong()->startExport();
 	// Skip first empty buffer.
@@ -182,10 +188,14 @@ void ProjectRenderer::run()
 	// Now start processing
 	Engine::audioEngine()->startProcessing(false);
 
+	// Encode in parallel to the rendering
+	m_fileDev->startEncoder();
+
 	// Continually track and emit progress percentage to listeners.
 	while (!Engine::getSong()->isExportDone() && !m_abort)
 	{
-		m_fileDev->processNextBuffer();
+		m_fileDev->queueNextBuffer();
+		renderedFrames += Engine::audioEngine()->framesPerPeriod();
 		const int nprog = Engine::getSong()->getExportProgress();
 		if (m_progress != nprog)
 		{
@@ -197,8 +207,15 @@ void ProjectRenderer::run()
 	// Notify the audio engine of the end of processing.
 	Engine::audioEngine()->stopProcessing();
 
+	// Wait for the encoder to catch up
+	m_fileDev->finishEncoder();
+
 	Engine::getSong()->stopExport();
 
+	m_renderedSeconds = static_cast<double>( renderedFrames ) /
+				Engine::audioEngine()->processingSampleRate();
+	m_renderTime = renderTimer.nsecsElapsed() / 1.0e9;
+
 	perfLog.end();
 
 	// If the user aborted export-process, the file has to be deleted.
@@ -35,9 +35,12 @@
 
 #include "BufferManager.h"
 #include "AudioEngine.h"
+#include "ConfigManager.h"
 #include "Engine.h"
 #include "Song.h"
 
+#include <algorithm>
+
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
@@ -144,6 +147,10 @@ RemotePlugin::RemotePlugin() :
 #endif
 	m_splitChannels( false ),
 	m_audioBufferSize( 0 ),
+	m_pipelined( ConfigManager::inst()->value( "audioengine",
+					"pipelinedremoteplugins" ).toInt() ),
+	m_slot( 0 ),
+	m_periodsInFlight( 0 ),
 	m_inputCount( DEFAULT_CHANNELS ),
 	m_outputCount( DEFAULT_CHANNELS )
 {
@@ -233,6 +240,7 @@ bool RemotePlugin::init(const QString &pluginExecutable,
 		reset( new shmFifo(), new shmFifo() );
 #endif
 		m_failed = false;
+		m_periodsInFlight = 0;
 	}
 	QString exec = QFileInfo(QDir("plugins:"), pluginExecutable).absoluteFilePath();
 #ifdef LMMS_BUILD_APPLE
@@ -331,6 +339,9 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 
 	if( m_failed || !isRunning() )
 	{
+		lock();
+		m_queuedMessages.clear();
+		unlock();
 		if( _out_buf != nullptr )
 		{
 			BufferManager::clear( _out_buf, frames );
@@ -350,6 +361,7 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 			fetchAndProcessAllMessages();
 			unlock();
 		}
+		sendQueuedMessages();
 		if( _out_buf != nullptr )
 		{
 			BufferManager::clear( _out_buf, frames );
@@ -357,7 +369,10 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 		return false;
 	}
 
-	memset( m_audioBuffer.get(), 0, m_audioBufferSize );
+	// in pipelined mode, each period uses one half of the shared memory
+	const std::size_t slotSize = ( m_inputCount + m_outputCount ) * frames;
+	float * buffer = m_audioBuffer.get() + m_slot * slotSize;
+	memset( buffer, 0, slotSize * sizeof( float ) );
 
 	ch_cnt_t inputs = qMin<ch_cnt_t>( m_inputCount, DEFAULT_CHANNELS );
 
@@ -369,18 +384,18 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 			{
 				for( fpp_t frame = 0; frame < frames; ++frame )
 				{
-					m_audioBuffer[ch * frames + frame] =
+					buffer[ch * frames + frame] =
 							_in_buf[frame][ch];
 				}
 			}
 		}
 		else if( inputs == DEFAULT_CHANNELS )
 		{
-			memcpy( m_audioBuffer.get(), _in_buf, frames * BYTES_PER_FRAME );
+			memcpy( buffer, _in_buf, frames * BYTES_PER_FRAME );
 		}
 		else
 		{
-			sampleFrame * o = (sampleFrame *) m_audioBuffer.get();
+			sampleFrame * o = (sampleFrame *) buffer;
 			for( ch_cnt_t ch = 0; ch < inputs; ++ch )
 			{
 				for( fpp_t frame = 0; frame < frames; ++frame )
@@ -392,7 +407,17 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 	}
 
 	lock();
-	sendMessage( IdStartProcessing );
+	sendQueuedMessages();
+	sendMessage( message( IdStartProcessing ).addInt( m_slot ) );
+	++m_periodsInFlight;
+
+	if( m_pipelined )
+	{
+		// the other half holds the previous period, which the plugin
+		// has been processing while we were busy with other things
+		m_slot = 1 - m_slot;
+		buffer = m_audioBuffer.get() + m_slot * slotSize;
+	}
 
 	if( m_failed || _out_buf == nullptr || m_outputCount == 0 )
 	{
@@ -400,7 +425,12 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 		return false;
 	}
 
-	waitForMessage( IdProcessingDone );
+	// IdProcessingDone is counted in processMessage(), also if it arrives
+	// while waiting for some other message
+	while( m_periodsInFlight > ( m_pipelined ? 1 : 0 ) && !m_failed && !isInvalid() )
+	{
+		fetchAndProcessNextMessage();
+	}
 	unlock();
 
 	const ch_cnt_t outputs = qMin<ch_cnt_t>( m_outputCount,
@@ -411,19 +441,19 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 		{
 			for( fpp_t frame = 0; frame < frames; ++frame )
 			{
-				_out_buf[frame][ch] = m_audioBuffer[( m_inputCount+ch )*
+				_out_buf[frame][ch] = buffer[( m_inputCount+ch )*
 								frames + frame];
 			}
 		}
 	}
 	else if( outputs == DEFAULT_CHANNELS )
 	{
-		memcpy( _out_buf, m_audioBuffer.get() + m_inputCount * frames,
+		memcpy( _out_buf, buffer + m_inputCount * frames,
 						frames * BYTES_PER_FRAME );
 	}
 	else
 	{
-		sampleFrame * o = (sampleFrame *) ( m_audioBuffer.get() +
+		sampleFrame * o = (sampleFrame *) ( buffer +
 							m_inputCount*frames );
 		// clear buffer, if plugin didn't fill up both channels
 		BufferManager::clear( _out_buf, frames );
@@ -444,6 +474,14 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 
 
 
+f_cnt_t RemotePlugin::latency() const
+{
+	return m_pipelined ? Engine::audioEngine()->framesPerPeriod() : 0;
+}
+
+
+
+
 void RemotePlugin::processMidiEvent( const MidiEvent & _e,
 							const f_cnt_t _offset )
 {
@@ -454,7 +492,69 @@ void RemotePlugin::processMidiEvent( const MidiEvent & _e,
 	m.addInt( _e.param( 1 ) );
 	m.addInt( _offset );
 	lock();
-	sendMessage( m );
+	queueMessage( m );
+	unlock();
+}
+
+
+
+
+void RemotePlugin::sendQueuedMessages()
+{
+	lock();
+	for( message & m : m_queuedMessages )
+	{
+		if( m.arguments() > 0 )
+		{
+			sendMessage( m );
+			m.clear();
+		}
+	}
+	unlock();
+}
+
+
+
+
+void RemotePlugin::queueMessage( const message & _m )
+{
+	lock();
+	const auto it = std::find( m_queuedMessages.begin(), m_queuedMessages.end(), _m );
+	if( it != m_queuedMessages.end() )
+	{
+		it->addArguments( _m );
+	}
+	else
+	{
+		m_queuedMessages.push_back( _m );
+	}
+	unlock();
+}
+
+
+
+
+void RemotePlugin::queueValueMessage( const message & _m )
+{
+	lock();
+	const auto it = std::find( m_queuedMessages.begin(), m_queuedMessages.end(), _m );
+	if( it == m_queuedMessages.end() )
+	{
+		m_queuedMessages.push_back( _m );
+		unlock();
+		return;
+	}
+
+	const int n = _m.arguments();
+	for( int p = 0; n > 0 && p + n <= it->arguments(); p += n )
+	{
+		if( it->getInt( p ) == _m.getInt( 0 ) && it->replaceArguments( p, _m ) )
+		{
+			unlock();
+			return;
+		}
+	}
+	it->addArguments( _m );
 	unlock();
 }
 
@@ -477,7 +577,8 @@ void RemotePlugin::hideUI()
 
 void RemotePlugin::resizeSharedProcessingMemory()
 {
-	const size_t s = (m_inputCount + m_outputCount) * Engine::audioEngine()->framesPerPeriod();
+	const size_t s = (m_inputCount + m_outputCount) * Engine::audioEngine()->framesPerPeriod()
+						* (m_pipelined ? 2 : 1);
 	try
 	{
 		m_audioBuffer.create(QUuid::createUuid().toString().toStdString(), s);
@@ -489,6 +590,8 @@ void RemotePlugin::resizeSharedProcessingMemory()
 		return;
 	}
 	m_audioBufferSize = s * sizeof(float);
+	// a period still in flight is processed in the old memory and lost
+	m_slot = 0;
 	sendMessage(message(IdChangeSharedMemoryKey).addString(m_audioBuffer.key()));
 }
 
@@ -566,6 +669,12 @@ bool RemotePlugin::processMessage( const message & _m )
 			break;
 
 		case IdProcessingDone:
+			if( m_periodsInFlight > 0 )
+			{
+				--m_periodsInFlight;
+			}
+			break;
+
 		case IdQuit:
 		default:
 			break;
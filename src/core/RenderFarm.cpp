@@ -0,0 +1,244 @@
+/*
+ * RenderFarm.cpp - renders several files at once in child processes
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "RenderFarm.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegExp>
+#include <QTextStream>
+
+#include <cstdio>
+
+
+namespace lmms
+{
+
+
+RenderFarm::RenderFarm( const QVector<Job> & jobs, int maxProcesses, QObject * parent ) :
+	QObject( parent ),
+	m_jobs( jobs ),
+	m_maxProcesses( qMax( 1, maxProcesses ) ),
+	m_nextJob( 0 ),
+	m_doneJobs( 0 ),
+	m_failed( 0 ),
+	m_audioSeconds( 0 ),
+	m_jobTimers( jobs.size() )
+{
+}
+
+
+
+
+RenderFarm::~RenderFarm()
+{
+	for( auto it = m_running.begin(); it != m_running.end(); ++it )
+	{
+		it.key()->kill();
+		it.key()->waitForFinished();
+	}
+}
+
+
+
+
+QVector<RenderFarm::Job> RenderFarm::jobsFromManifest( const QString & manifest,
+				const QString & outputDir, const QString & extension,
+				const QStringList & renderArguments )
+{
+	QFile file( manifest );
+	if( !file.open( QIODevice::ReadOnly | QIODevice::Text ) )
+	{
+		fprintf( stderr, "Could not open manifest %s\n", manifest.toUtf8().constData() );
+		return {};
+	}
+
+	const QDir manifestDir = QFileInfo( manifest ).absoluteDir();
+	QVector<Job> jobs;
+	QTextStream stream( &file );
+	while( !stream.atEnd() )
+	{
+		const QString line = stream.readLine().trimmed();
+		if( line.isEmpty() || line.startsWith( '#' ) )
+		{
+			continue;
+		}
+
+		const QStringList fields = line.split( '\t', QString::SkipEmptyParts );
+		const QString project = manifestDir.absoluteFilePath( fields[0].trimmed() );
+		if( !QFileInfo( project ).isFile() )
+		{
+			fprintf( stderr, "Project %s from the manifest does not exist\n",
+						project.toUtf8().constData() );
+			return {};
+		}
+
+		QString output;
+		if( fields.size() > 1 )
+		{
+			output = manifestDir.absoluteFilePath( fields[1].trimmed() );
+		}
+		else
+		{
+			const QFileInfo info( project );
+			const QDir dir = outputDir.isEmpty() ? info.absoluteDir() : QDir( outputDir );
+			output = dir.absoluteFilePath( info.completeBaseName() + extension );
+		}
+
+		jobs.push_back( { QStringList{ "render", project, "--output", output } + renderArguments,
+					output } );
+	}
+
+	return jobs;
+}
+
+
+
+
+void RenderFarm::start()
+{
+	m_wallClock.start();
+
+	while( m_running.size() < m_maxProcesses && m_nextJob < m_jobs.size() )
+	{
+		startNextJob();
+	}
+
+	if( m_jobs.isEmpty() )
+	{
+		// the caller connects to finished() before running the event loop
+		QMetaObject::invokeMethod( this, "finished", Qt::QueuedConnection );
+	}
+}
+
+
+
+
+void RenderFarm::startNextJob()
+{
+	const int index = m_nextJob++;
+
+	QProcess * process = new QProcess( this );
+	// the children print their progress bar on stderr, only show it if
+	// something went wrong
+	process->setProcessChannelMode( QProcess::SeparateChannels );
+	connect( process, SIGNAL(finished(int,QProcess::ExitStatus)),
+		this, SLOT(jobFinished(int,QProcess::ExitStatus)) );
+	connect( process, SIGNAL(errorOccurred(QProcess::ProcessError)),
+		this, SLOT(jobErrored(QProcess::ProcessError)) );
+
+	m_running.insert( process, index );
+	m_jobTimers[index].start();
+	process->start( QCoreApplication::applicationFilePath(), m_jobs[index].arguments );
+
+	printf( "Started %s (%d/%d)\n", m_jobs[index].outputPath.toUtf8().constData(),
+						index + 1, m_jobs.size() );
+	fflush( stdout );
+}
+
+
+
+
+void RenderFarm::jobFinished( int exitCode, QProcess::ExitStatus exitStatus )
+{
+	completeJob( qobject_cast<QProcess *>( sender() ),
+			exitStatus == QProcess::NormalExit && exitCode == 0, exitCode );
+}
+
+
+
+
+void RenderFarm::jobErrored( QProcess::ProcessError error )
+{
+	// all other errors are followed by finished()
+	if( error == QProcess::FailedToStart )
+	{
+		completeJob( qobject_cast<QProcess *>( sender() ), false, -1 );
+	}
+}
+
+
+
+
+void RenderFarm::completeJob( QProcess * process, bool exitedNormally, int exitCode )
+{
+	if( !process || !m_running.contains( process ) )
+	{
+		return;
+	}
+
+	const int index = m_running.take( process );
+	const Job & job = m_jobs[index];
+	const double seconds = m_jobTimers[index].nsecsElapsed() / 1.0e9;
+	++m_doneJobs;
+
+	// RenderManager prints "<seconds> s of audio in ..." for every file
+	// it has written
+	const QString out = QString::fromLocal8Bit( process->readAllStandardOutput() );
+	QRegExp rendered( "([0-9.]+) s of audio in" );
+	double audioSeconds = 0;
+	for( int pos = rendered.indexIn( out ); pos >= 0;
+		pos = rendered.indexIn( out, pos + rendered.matchedLength() ) )
+	{
+		audioSeconds += rendered.cap( 1 ).toDouble();
+	}
+
+	if( !exitedNormally || audioSeconds <= 0 )
+	{
+		++m_failed;
+		fprintf( stderr, "[%d/%d] %s failed (exit code %d):\n%s\n",
+				m_doneJobs, m_jobs.size(), job.outputPath.toUtf8().constData(), exitCode,
+				process->readAllStandardError().constData() );
+	}
+	else
+	{
+		m_audioSeconds += audioSeconds;
+		printf( "[%d/%d] %s: %.1f s of audio in %.1f s (%.1fx realtime)\n",
+				m_doneJobs, m_jobs.size(), job.outputPath.toUtf8().constData(),
+				audioSeconds, seconds, audioSeconds / seconds );
+		fflush( stdout );
+	}
+
+	process->deleteLater();
+
+	if( m_nextJob < m_jobs.size() )
+	{
+		startNextJob();
+	}
+	else if( m_running.isEmpty() )
+	{
+		const double wallClock = m_wallClock.nsecsElapsed() / 1.0e9;
+		printf( "\nRendered %d of %d files: %.1f s of audio in %.1f s with %d processes "
+				"(%.1fx realtime)\n",
+				m_jobs.size() - m_failed, m_jobs.size(), m_audioSeconds, wallClock,
+				m_maxProcesses, m_audioSeconds / wallClock );
+		fflush( stdout );
+		emit finished();
+	}
+}
+
+
+} // namespace lmms
@@ -43,7 +43,8 @@ RenderManager::RenderManager(
 	m_oldQualitySettings( Engine::audioEngine()->currentQualitySettings() ),
 	m_outputSettings(outputSettings),
 	m_format(fmt),
-	m_outputPath(outputPath)
+	m_outputPath(outputPath),
+	m_renderCount(0)
 {
 	Engine::audioEngine()->storeAudioDevice();
 }
@@ -67,6 +68,10 @@ void RenderManager::abortProcessing()
 // Called to render each new track when rendering tracks individually.
 void RenderManager::renderNextTrack()
 {
+	if( m_activeRenderer && m_activeRenderer->isReady() )
+	{
+		reportThroughput();
+	}
 	m_activeRenderer.reset();
 
 	if( m_tracksToRender.isEmpty() )
@@ -88,52 +93,65 @@ void RenderManager::renderNextTrack()
 		}
 
 		// for multi-render, prefix each output file with a different number
-		int trackNum = m_tracksToRender.size() + 1;
+		int trackNum = m_unmuted.indexOf(renderTrack) + 1;
 
 		render( pathForTrack(renderTrack, trackNum) );
 	}
 }
 
-// Render the song into individual tracks
-void RenderManager::renderTracks()
+// Collect all currently unmuted tracks which can be rendered
+QVector<Track*> RenderManager::renderableTracks()
 {
-	const TrackContainer::TrackList & tl = Engine::getSong()->tracks();
-
-	// find all currently unnmuted tracks -- we want to render these.
-	for( auto it = tl.begin(); it != tl.end(); ++it )
+	QVector<Track*> tracks;
+	for( const TrackContainer * tc : { static_cast<TrackContainer*>(Engine::getSong()),
+				static_cast<TrackContainer*>(Engine::patternStore()) } )
 	{
-		Track* tk = (*it);
-		Track::TrackTypes type = tk->type();
-
-		// Don't render automation tracks
-		if ( tk->isMuted() == false &&
-				( type == Track::InstrumentTrack || type == Track::SampleTrack ) )
+		for( Track* tk : tc->tracks() )
 		{
-			m_unmuted.push_back(tk);
+			Track::TrackTypes type = tk->type();
+
+			// Don't render automation tracks
+			if ( tk->isMuted() == false &&
+					( type == Track::InstrumentTrack || type == Track::SampleTrack ) )
+			{
+				tracks.push_back(tk);
+			}
 		}
 	}
+	return tracks;
+}
 
-	const TrackContainer::TrackList t2 = Engine::patternStore()->tracks();
-	for( auto it = t2.begin(); it != t2.end(); ++it )
-	{
-		Track* tk = (*it);
-		Track::TrackTypes type = tk->type();
-
-		// Don't render automation tracks
-		if ( tk->isMuted() == false &&
-				( type == Track::InstrumentTrack || type == Track::SampleTrack ) )
-		{
-			m_unmuted.push_back(tk);
-		}
-	}
+// Render the song into individual tracks
+void RenderManager::renderTracks( int stem )
+{
+	m_unmuted = renderableTracks();
 
 	// copy the list of unmuted tracks into our rendering queue.
 	// we need to remember which tracks were unmuted to restore state at the end.
-	m_tracksToRender = m_unmuted;
+	if( stem < 0 )
+	{
+		m_tracksToRender = m_unmuted;
+	}
+	else if( stem < m_unmuted.size() )
+	{
+		m_tracksToRender = { m_unmuted[stem] };
+	}
+	m_renderCount = m_tracksToRender.size();
 
 	renderNextTrack();
 }
 
+QStringList RenderManager::trackPaths() const
+{
+	const QVector<Track*> tracks = renderableTracks();
+	QStringList paths;
+	for( int i = 0; i < tracks.size(); ++i )
+	{
+		paths << pathForTrack( tracks[i], i + 1 );
+	}
+	return paths;
+}
+
 // Render the song into a single track
 void RenderManager::renderProject()
 {
@@ -180,7 +198,7 @@ void RenderManager::restoreMutedState()
 }
 
 // Determine the output path for a track when rendering tracks individually
-QString RenderManager::pathForTrack(const Track *track, int num)
+QString RenderManager::pathForTrack(const Track *track, int num) const
 {
 	QString extension = ProjectRenderer::getFileExtensionFromFormat( m_format );
 	QString name = track->name();
@@ -195,7 +213,7 @@ void RenderManager::updateConsoleProgress()
 	{
 		m_activeRenderer->updateConsoleProgress();
 
-		int totalNum = m_unmuted.size();
+		int totalNum = m_renderCount;
 		if ( totalNum > 0 )
 		{
 			// we are rendering multiple tracks, append a track counter to the output
@@ -205,5 +223,17 @@ void RenderManager::updateConsoleProgress()
 	}
 }
 
+// Print how fast the last file was rendered. RenderFarm parses this from
+// the output of its child processes, so keep the "s of audio in" part.
+void RenderManager::reportThroughput() const
+{
+	const double audio = m_activeRenderer->renderedSeconds();
+	const double time = m_activeRenderer->renderTime();
+	printf( "\nRendered %s: %.3f s of audio in %.3f s (%.1fx realtime)\n",
+			m_activeRenderer->outputFile().toUtf8().constData(), audio, time,
+			time > 0 ? audio / time : 0.0 );
+	fflush( stdout );
+}
+
 
 } // namespace lmms
\ No newline at end of file
@@ -58,6 +58,8 @@
 #include "GuiApplication.h"
 #include "Note.h"
 #include "PathUtil.h"
+#include "SampleStream.h"
+#include "Song.h"
 
 #include "FileDialog.h"
 
@@ -78,7 +80,11 @@ SampleBuffer::SampleBuffer() :
 	m_amplification(1.0f),
 	m_reversed(false),
 	m_frequency(DefaultBaseFreq),
-	m_sampleRate(audioEngineSampleRate())
+	m_sampleRate(audioEngineSampleRate()),
+	m_streamable(false),
+	m_streamed(false),
+	m_headFrames(0),
+	m_stream(nullptr)
 {
 
 	connect(Engine::audioEngine(), SIGNAL(sampleRateChanged()), this, SLOT(sampleRateChanged()));
@@ -142,7 +148,12 @@ SampleBuffer::SampleBuffer(const SampleBuffer& orig)
 	m_origFrames = orig.m_origFrames;
 	m_origData = (m_origFrames > 0) ? MM_ALLOC<sampleFrame>( m_origFrames) : nullptr;
 	m_frames = orig.m_frames;
-	m_data = (m_frames > 0) ? MM_ALLOC<sampleFrame>( m_frames) : nullptr;
+	m_streamable = orig.m_streamable;
+	m_streamed = orig.m_streamed;
+	m_headFrames = orig.m_headFrames;
+	m_overview = orig.m_overview;
+	m_stream = m_streamed ? SampleStream::create(PathUtil::toAbsolute(m_audioFile), orig.m_reversed) : nullptr;
+	m_data = (dataFrames() > 0) ? MM_ALLOC<sampleFrame>( dataFrames()) : nullptr;
 	m_startFrame = orig.m_startFrame;
 	m_endFrame = orig.m_endFrame;
 	m_loopStartFrame = orig.m_loopStartFrame;
@@ -154,7 +165,7 @@ SampleBuffer::SampleBuffer(const SampleBuffer& orig)
 
 	//Deep copy m_origData and m_data from original
 	const auto origFrameBytes = m_origFrames * BYTES_PER_FRAME;
-	const auto frameBytes = m_frames * BYTES_PER_FRAME;
+	const auto frameBytes = dataFrames() * BYTES_PER_FRAME;
 	if (orig.m_origData != nullptr && origFrameBytes > 0)
 		{ memcpy(m_origData, orig.m_origData, origFrameBytes); }
 	if (orig.m_data != nullptr && frameBytes > 0)
@@ -196,6 +207,11 @@ void swap(SampleBuffer& first, SampleBuffer& second) noexcept
 	swap(first.m_frequency, second.m_frequency);
 	swap(first.m_reversed, second.m_reversed);
 	swap(first.m_sampleRate, second.m_sampleRate);
+	swap(first.m_streamable, second.m_streamable);
+	swap(first.m_streamed, second.m_streamed);
+	swap(first.m_headFrames, second.m_headFrames);
+	first.m_overview.swap(second.m_overview);
+	swap(first.m_stream, second.m_stream);
 
 	// Unlock again
 	first.m_varLock.unlock();
@@ -218,6 +234,10 @@ SampleBuffer::~SampleBuffer()
 {
 	MM_FREE(m_origData);
 	MM_FREE(m_data);
+	if (m_stream != nullptr)
+	{
+		m_stream->release();
+	}
 }
 
 
@@ -235,6 +255,51 @@ sample_rate_t SampleBuffer::audioEngineSampleRate()
 
 void SampleBuffer::update(bool keepSettings)
 {
+	// File size and sample length limits
+	const int fileSizeMax = 300; // MB
+	const int sampleLengthMax = 90; // Minutes
+	// Streamable samples longer than this are played from disk
+	const int streamLengthMin = 10; // Minutes
+
+	bool fileLoadError = false;
+	bool streamFile = false;
+	const QString file = m_audioFile.isEmpty() ? QString() : PathUtil::toAbsolute(m_audioFile);
+	const QFileInfo fileInfo(file);
+	if (!file.isEmpty())
+	{
+		if (fileInfo.size() > fileSizeMax * 1024 * 1024)
+		{
+			fileLoadError = true;
+		}
+		if (!fileLoadError || m_streamable)
+		{
+			// Use QFile to handle unicode file names on Windows
+			QFile f(file);
+			SNDFILE * sndFile;
+			SF_INFO sfInfo;
+			sfInfo.format = 0;
+			if (f.open(QIODevice::ReadOnly) && (sndFile = sf_open_fd(f.handle(), SFM_READ, &sfInfo, false)))
+			{
+				f_cnt_t frames = sfInfo.frames;
+				int rate = sfInfo.samplerate;
+				if (frames / rate > sampleLengthMax * 60)
+				{
+					fileLoadError = true;
+				}
+				streamFile = frames / rate > streamLengthMin * 60;
+				sf_close(sndFile);
+			}
+			f.close();
+		}
+	}
+
+	// Scanning a file for streaming takes as long as reading all of it, so
+	// it's done before the audio engine is stopped
+	StreamedSample streamed;
+	const bool streamedLoaded = m_streamable && (fileLoadError || streamFile)
+					&& loadStreamed(file, m_reversed, streamed);
+	SampleStream * stream = streamedLoaded ? SampleStream::create(file, m_reversed) : nullptr;
+
 	const bool lock = (m_data != nullptr);
 	if (lock)
 	{
@@ -243,11 +308,13 @@ void SampleBuffer::update(bool keepSettings)
 		MM_FREE(m_data);
 	}
 
-	// File size and sample length limits
-	const int fileSizeMax = 300; // MB
-	const int sampleLengthMax = 90; // Minutes
-
-	bool fileLoadError = false;
+	m_streamed = false;
+	m_overview.clear();
+	if (m_stream != nullptr)
+	{
+		m_stream->release();
+		m_stream = nullptr;
+	}
 	if (m_audioFile.isEmpty() && m_origData != nullptr && m_origFrames > 0)
 	{
 		// TODO: reverse- and amplification-property is not covered
@@ -263,39 +330,24 @@ void SampleBuffer::update(bool keepSettings)
 	}
 	else if (!m_audioFile.isEmpty())
 	{
-		QString file = PathUtil::toAbsolute(m_audioFile);
 		int_sample_t * buf = nullptr;
 		sample_t * fbuf = nullptr;
 		ch_cnt_t channels = DEFAULT_CHANNELS;
 		sample_rate_t samplerate = audioEngineSampleRate();
 		m_frames = 0;
 
-		const QFileInfo fileInfo(file);
-		if (fileInfo.size() > fileSizeMax * 1024 * 1024)
-		{
-			fileLoadError = true;
-		}
-		else
+		if (streamedLoaded)
 		{
-			// Use QFile to handle unicode file names on Windows
-			QFile f(file);
-			SNDFILE * sndFile;
-			SF_INFO sfInfo;
-			sfInfo.format = 0;
-			if (f.open(QIODevice::ReadOnly) && (sndFile = sf_open_fd(f.handle(), SFM_READ, &sfInfo, false)))
-			{
-				f_cnt_t frames = sfInfo.frames;
-				int rate = sfInfo.samplerate;
-				if (frames / rate > sampleLengthMax * 60)
-				{
-					fileLoadError = true;
-				}
-				sf_close(sndFile);
-			}
-			f.close();
+			m_data = streamed.head;
+			m_headFrames = streamed.headFrames;
+			m_frames = streamed.frames;
+			m_overview.swap(streamed.overview);
+			m_stream = stream;
+			m_streamed = true;
+			// no limits when playing from disk
+			fileLoadError = false;
 		}
-
-		if (!fileLoadError)
+		else if (!fileLoadError)
 		{
 #ifdef LMMS_HAVE_OGGVORBIS
 			// workaround for a bug in libsndfile or our libsndfile decoder
@@ -361,7 +413,11 @@ void SampleBuffer::update(bool keepSettings)
 	{
 		m_userAntiAliasWaveTable = std::make_unique<OscillatorConstants::waveform_t>();
 	}
-	Oscillator::generateAntiAliasUserWaveTable(this);
+	// streamed samples are never used as a waveform
+	if (!m_streamed)
+	{
+		Oscillator::generateAntiAliasUserWaveTable(this);
+	}
 
 	if (fileLoadError)
 	{
@@ -467,6 +523,83 @@ void SampleBuffer::normalizeSampleRate(const sample_rate_t srcSR, bool keepSetti
 
 
 
+bool SampleBuffer::loadStreamed(const QString & file, bool reversed, StreamedSample & sample)
+{
+	// The overview is kept in the order of the file, so reversing the sample
+	// doesn't need another pass over all of it
+	SampleFileReader reader(file, false, audioEngineSampleRate());
+	if (!reader.isOpen())
+	{
+		return false;
+	}
+
+	// The file is read once for the overview. Its first seconds are kept,
+	// so playback from the start doesn't have to wait for the disk.
+	const f_cnt_t headFrames = qMin<f_cnt_t>(reader.frames(), HeadSeconds * audioEngineSampleRate());
+	sampleFrame * head = MM_ALLOC<sampleFrame>( qMax<f_cnt_t>(headFrames, 1));
+	std::vector<OverviewPoint> overview;
+	overview.reserve(reader.frames() / OverviewFrames + 1);
+
+	std::vector<sampleFrame> block(OverviewFrames);
+	f_cnt_t frames = 0;
+	f_cnt_t read;
+	while ((read = reader.read(block.data(), OverviewFrames)) > 0)
+	{
+		if (frames < headFrames)
+		{
+			memcpy(head + frames, block.data(), qMin(read, headFrames - frames) * BYTES_PER_FRAME);
+		}
+
+		OverviewPoint point = { 1, -1, 0 };
+		for (f_cnt_t f = 0; f < read; ++f)
+		{
+			for (int ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+			{
+				point.min = std::min(point.min, block[f][ch]);
+				point.max = std::max(point.max, block[f][ch]);
+				point.meanSquare += block[f][ch] * block[f][ch];
+			}
+		}
+		point.meanSquare /= DEFAULT_CHANNELS * read;
+		overview.push_back(point);
+		frames += read;
+	}
+
+	if (frames == 0 || (reversed && !loadStreamedHead(file, true, qMin(headFrames, frames), head)))
+	{
+		MM_FREE(head);
+		return false;
+	}
+
+	sample.head = head;
+	sample.headFrames = qMin(headFrames, frames);
+	sample.frames = frames;
+	sample.overview.swap(overview);
+	return true;
+}
+
+
+
+
+bool SampleBuffer::loadStreamedHead(const QString & file, bool reversed, f_cnt_t frames,
+					sampleFrame * head)
+{
+	SampleFileReader reader(file, reversed, audioEngineSampleRate());
+	if (!reader.isOpen())
+	{
+		return false;
+	}
+	const f_cnt_t read = reader.read(head, frames);
+	if (read < frames)
+	{
+		memset(head + read, 0, (frames - read) * BYTES_PER_FRAME);
+	}
+	return true;
+}
+
+
+
+
 f_cnt_t SampleBuffer::decodeSampleSF(
 	QString fileName,
 	sample_t * & buf,
@@ -717,6 +850,11 @@ bool SampleBuffer::play(
 		return false;
 	}
 
+	if (m_streamed)
+	{
+		return playStreamed(ab, state, frames);
+	}
+
 	// variable for determining if we should currently be playing backwards in a ping-pong loop
 	bool isBackwards = state->isBackwards();
 
@@ -874,6 +1012,58 @@ bool SampleBuffer::play(
 
 
 
+bool SampleBuffer::playStreamed(sampleFrame * ab, handleState * state, const fpp_t frames)
+{
+	const f_cnt_t endFrame = m_endFrame;
+	const f_cnt_t playFrame = qMax(state->m_frameIndex, m_startFrame);
+	if (playFrame >= endFrame)
+	{
+		return false;
+	}
+
+	const f_cnt_t todo = qMin<f_cnt_t>(frames, endFrame - playFrame);
+	f_cnt_t done = 0;
+	if (playFrame < m_headFrames)
+	{
+		done = qMin(todo, m_headFrames - playFrame);
+		memcpy(ab, m_data + playFrame, done * BYTES_PER_FRAME);
+	}
+
+	// Start reading right away, so the disk is read while the head plays.
+	// Start again if the position was changed from outside.
+	const f_cnt_t streamFrame = qMax(playFrame, m_headFrames);
+	if (!m_stream->isPlaying(state->m_streamPlayback) || state->m_streamFrame != streamFrame)
+	{
+		state->m_streamPlayback = m_stream->start(streamFrame);
+		state->m_streamFrame = streamFrame;
+	}
+
+	if (done < todo)
+	{
+		// when rendering, there's time to wait for the disk
+		m_stream->read(state->m_streamPlayback, ab + done, todo - done, Engine::getSong()->isExporting());
+		state->m_streamFrame = playFrame + todo;
+	}
+
+	if (todo < frames)
+	{
+		memset(ab + todo, 0, (frames - todo) * BYTES_PER_FRAME);
+	}
+
+	state->setFrameIndex(playFrame + todo);
+
+	for (fpp_t i = 0; i < todo; ++i)
+	{
+		ab[i][0] *= m_amplification;
+		ab[i][1] *= m_amplification;
+	}
+
+	return true;
+}
+
+
+
+
 sampleFrame * SampleBuffer::getSampleFragment(
 	f_cnt_t index,
 	f_cnt_t frames,
@@ -1071,8 +1261,33 @@ void SampleBuffer::visualize(
 
 		float rmsData[2] = {0, 0};
 
+		if (m_streamed)
+		{
+			// only the overview of streamed samples is in memory
+			auto from = static_cast<std::size_t>(frame);
+			auto to = static_cast<std::size_t>(std::min(frame + fpp, last + 1.) - 1);
+			if (m_reversed)
+			{
+				// the overview is in the order of the file
+				const auto end = static_cast<std::size_t>(m_frames - 1);
+				from = end - std::min(to, end);
+				to = end - std::min(static_cast<std::size_t>(frame), end);
+			}
+			const auto firstPoint = from / OverviewFrames;
+			const auto lastPoint = std::min(to / OverviewFrames, m_overview.size() - 1);
+			float meanSquare = 0;
+			for (auto i = firstPoint; i <= lastPoint; ++i)
+			{
+				maxData = std::max(maxData, m_overview[i].max);
+				minData = std::min(minData, m_overview[i].min);
+				meanSquare += m_overview[i].meanSquare;
+			}
+			meanSquare /= lastPoint - firstPoint + 1;
+			rmsData[0] = rmsData[1] = meanSquare * fpp;
+		}
+
 		// Find maximum and minimum samples within range
-		for (int i = 0; i < fpp && frame + i <= last; ++i)
+		for (int i = 0; i < fpp && frame + i <= last && !m_streamed; ++i)
 		{
 			for (int j = 0; j < 2; ++j)
 			{
@@ -1555,6 +1770,35 @@ void SampleBuffer::setAmplification(float a)
 
 void SampleBuffer::setReversed(bool on)
 {
+	if (m_streamed)
+	{
+		if (m_reversed == on) { return; }
+
+		// only the beginning has to be read from the other end, the
+		// overview is in the order of the file
+		const QString file = PathUtil::toAbsolute(m_audioFile);
+		sampleFrame * head = MM_ALLOC<sampleFrame>( qMax<f_cnt_t>(m_headFrames, 1));
+		if (!loadStreamedHead(file, on, m_headFrames, head))
+		{
+			MM_FREE(head);
+			return;
+		}
+		SampleStream * stream = SampleStream::create(file, on);
+
+		Engine::audioEngine()->requestChangeInModel();
+		m_varLock.lockForWrite();
+		std::swap(m_data, head);
+		m_stream->release();
+		m_stream = stream;
+		m_reversed = on;
+		m_varLock.unlock();
+		Engine::audioEngine()->doneChangeInModel();
+
+		MM_FREE(head);
+		emit sampleUpdated();
+		return;
+	}
+
 	Engine::audioEngine()->requestChangeInModel();
 	m_varLock.lockForWrite();
 	if (m_reversed != on) { std::reverse(m_data, m_data + m_frames); }
@@ -1571,7 +1815,9 @@ void SampleBuffer::setReversed(bool on)
 SampleBuffer::handleState::handleState(bool varyingPitch, int interpolationMode) :
 	m_frameIndex(0),
 	m_varyingPitch(varyingPitch),
-	m_isBackwards(false)
+	m_isBackwards(false),
+	m_streamPlayback(0),
+	m_streamFrame(0)
 {
 	int error;
 	m_interpolationMode = interpolationMode;
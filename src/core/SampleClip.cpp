@@ -41,6 +41,8 @@ SampleClip::SampleClip( Track * _track ) :
 	m_sampleBuffer( new SampleBuffer ),
 	m_isPlaying( false )
 {
+	// long recordings and stems are played from disk
+	m_sampleBuffer->setStreamable( true );
 	saveJournallingState( false );
 	setSampleFile( "" );
 	restoreJournallingState();
@@ -102,12 +104,13 @@ SampleClip::SampleClip(const SampleClip& orig) :
 
 SampleClip::~SampleClip()
 {
+	// keep the track from playing this clip while it's being destroyed
+	Engine::audioEngine()->requestChangeInModel();
 	SampleTrack * sampletrack = dynamic_cast<SampleTrack*>( getTrack() );
 	if ( sampletrack )
 	{
 		sampletrack->updateClips();
 	}
-	Engine::audioEngine()->requestChangeInModel();
 	sharedObject::unref( m_sampleBuffer );
 	Engine::audioEngine()->doneChangeInModel();
 }
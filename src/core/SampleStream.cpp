@@ -0,0 +1,534 @@
+/*
+ * SampleStream.cpp - plays sound files from disk instead of from memory
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SampleStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+
+
+namespace lmms
+{
+
+
+namespace
+{
+
+//! Frames decoded from the file at once
+constexpr f_cnt_t InputFrames = 4096;
+//! Frames the streamer thread puts into a ring buffer at once
+constexpr f_cnt_t ChunkFrames = 4096;
+//! How far each stream reads ahead
+constexpr int BufferSeconds = 2;
+
+constexpr auto PollInterval = std::chrono::milliseconds( 10 );
+
+//! Ids of playbacks are unique among all streams, 0 means none
+std::atomic<int> s_lastPlayback( 0 );
+
+}
+
+
+
+
+SampleFileReader::SampleFileReader( const QString & file, bool reversed,
+						sample_rate_t sampleRate ) :
+	m_file( file ),
+	m_sndFile( nullptr ),
+	m_reversed( reversed ),
+	m_ratio( 1.0 ),
+	m_frames( 0 ),
+	m_resampler( nullptr ),
+	m_filePos( 0 ),
+	m_inputPos( 0 ),
+	m_inputFrames( 0 ),
+	m_endOfInput( false )
+{
+	m_info.format = 0;
+	// Use QFile to handle unicode file names on Windows
+	if( m_file.open( QIODevice::ReadOnly ) )
+	{
+		m_sndFile = sf_open_fd( m_file.handle(), SFM_READ, &m_info, false );
+	}
+	if( m_sndFile == nullptr )
+	{
+		return;
+	}
+
+	m_ratio = static_cast<double>( sampleRate ) / m_info.samplerate;
+	if( m_ratio != 1.0 )
+	{
+		int error;
+		m_resampler = src_new( SRC_SINC_MEDIUM_QUALITY, DEFAULT_CHANNELS, &error );
+	}
+	if( m_info.frames <= 0 || m_info.channels <= 0 ||
+		( m_ratio != 1.0 && m_resampler == nullptr ) )
+	{
+		sf_close( m_sndFile );
+		m_sndFile = nullptr;
+		return;
+	}
+
+	m_frames = static_cast<f_cnt_t>( m_info.frames * m_ratio );
+	m_fileBuffer.resize( InputFrames * m_info.channels );
+	m_input.resize( InputFrames );
+	seek( 0 );
+}
+
+
+
+
+SampleFileReader::~SampleFileReader()
+{
+	if( m_resampler != nullptr )
+	{
+		src_delete( m_resampler );
+	}
+	if( m_sndFile != nullptr )
+	{
+		sf_close( m_sndFile );
+	}
+}
+
+
+
+
+void SampleFileReader::seek( f_cnt_t frame )
+{
+	m_filePos = qBound<sf_count_t>( 0, std::llround( frame / m_ratio ), m_info.frames );
+	m_inputPos = m_inputFrames = 0;
+	m_endOfInput = false;
+	if( m_resampler != nullptr )
+	{
+		src_reset( m_resampler );
+	}
+	if( !m_reversed )
+	{
+		sf_seek( m_sndFile, m_filePos, SEEK_SET );
+	}
+}
+
+
+
+
+f_cnt_t SampleFileReader::read( sampleFrame * dst, f_cnt_t frames )
+{
+	f_cnt_t done = 0;
+	while( done < frames )
+	{
+		if( m_inputPos == m_inputFrames && !m_endOfInput )
+		{
+			readInput();
+		}
+
+		if( m_resampler == nullptr )
+		{
+			const f_cnt_t todo = qMin( frames - done, m_inputFrames - m_inputPos );
+			if( todo == 0 )
+			{
+				break;
+			}
+			memcpy( dst + done, m_input.data() + m_inputPos, todo * BYTES_PER_FRAME );
+			m_inputPos += todo;
+			done += todo;
+			continue;
+		}
+
+		SRC_DATA srcData;
+		srcData.data_in = m_input[0].data() + m_inputPos * DEFAULT_CHANNELS;
+		srcData.input_frames = m_inputFrames - m_inputPos;
+		srcData.data_out = dst[0].data() + done * DEFAULT_CHANNELS;
+		srcData.output_frames = frames - done;
+		srcData.src_ratio = m_ratio;
+		srcData.end_of_input = m_endOfInput ? 1 : 0;
+		const int error = src_process( m_resampler, &srcData );
+		if( error )
+		{
+			printf( "SampleFileReader: error while resampling: %s\n",
+							src_strerror( error ) );
+			break;
+		}
+		m_inputPos += srcData.input_frames_used;
+		done += srcData.output_frames_gen;
+		if( srcData.output_frames_gen == 0 && m_endOfInput )
+		{
+			break;
+		}
+	}
+	return done;
+}
+
+
+
+
+void SampleFileReader::readInput()
+{
+	m_inputPos = m_inputFrames = 0;
+	const sf_count_t count = qMin<sf_count_t>( InputFrames, m_info.frames - m_filePos );
+	if( count > 0 && m_reversed )
+	{
+		sf_seek( m_sndFile, m_info.frames - m_filePos - count, SEEK_SET );
+	}
+	const sf_count_t read = count > 0 ?
+			sf_readf_float( m_sndFile, m_fileBuffer.data(), count ) : 0;
+	if( read < count || count == 0 )
+	{
+		m_endOfInput = true;
+	}
+	if( read <= 0 )
+	{
+		return;
+	}
+
+	const int channels = m_info.channels;
+	const int ch = ( channels > 1 ) ? 1 : 0;
+	for( f_cnt_t f = 0; f < read; ++f )
+	{
+		// reversed pieces are read forwards and turned around here
+		const float * in = m_fileBuffer.data() +
+				( m_reversed ? read - 1 - f : f ) * channels;
+		m_input[f][0] = in[0];
+		m_input[f][1] = in[ch];
+	}
+	m_filePos += read;
+	m_inputFrames = read;
+}
+
+
+
+
+//! The thread which reads ahead for all streams. New streams are handed over
+//! through a lock-free list, released ones are deleted here.
+class SampleStreamer
+{
+public:
+	static SampleStreamer & inst()
+	{
+		static SampleStreamer streamer;
+		return streamer;
+	}
+
+	void add( SampleStream * stream )
+	{
+		stream->m_next = m_newStreams.load( std::memory_order_relaxed );
+		while( !m_newStreams.compare_exchange_weak( stream->m_next, stream,
+				std::memory_order_release, std::memory_order_relaxed ) ) {}
+		wakeUp();
+	}
+
+	void wakeUp()
+	{
+		m_wakeUp = true;
+		m_condition.notify_one();
+	}
+
+private:
+	SampleStreamer() :
+		m_newStreams( nullptr ),
+		m_wakeUp( false ),
+		m_quit( false ),
+		m_thread( [this] { run(); } )
+	{
+	}
+
+	~SampleStreamer()
+	{
+		m_quit = true;
+		wakeUp();
+		m_thread.join();
+		adoptNewStreams();
+		for( SampleStream * stream : m_streams )
+		{
+			delete stream;
+		}
+	}
+
+	void adoptNewStreams()
+	{
+		SampleStream * stream = m_newStreams.exchange( nullptr, std::memory_order_acquire );
+		while( stream != nullptr )
+		{
+			m_streams.push_back( stream );
+			stream = stream->m_next;
+		}
+	}
+
+	void run()
+	{
+		while( !m_quit )
+		{
+			adoptNewStreams();
+
+			bool busy = false;
+			for( auto it = m_streams.begin(); it != m_streams.end(); )
+			{
+				if( ( *it )->m_released )
+				{
+					delete *it;
+					it = m_streams.erase( it );
+					continue;
+				}
+				busy = ( *it )->fill() || busy;
+				++it;
+			}
+
+			if( !busy )
+			{
+				std::unique_lock<std::mutex> lock( m_mutex );
+				m_condition.wait_for( lock, PollInterval,
+					[this] { return m_wakeUp.exchange( false ) || m_quit; } );
+			}
+		}
+	}
+
+	std::atomic<SampleStream *> m_newStreams;
+	std::atomic<bool> m_wakeUp;
+	std::atomic<bool> m_quit;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::vector<SampleStream *> m_streams;
+	std::thread m_thread;
+} ;
+
+
+
+
+SampleStream::SampleStream( const QString & file, bool reversed, f_cnt_t bufferFrames ) :
+	m_file( file ),
+	m_reversed( reversed ),
+	m_fileReaderRate( 0 ),
+	m_chunk( ChunkFrames ),
+	m_next( nullptr ),
+	m_serving( 0 ),
+	m_missed( 0 ),
+	m_buffer( bufferFrames ),
+	m_bufferReader( m_buffer ),
+	m_playback( 0 ),
+	m_from( 0 ),
+	m_flushRequest( 0 ),
+	m_flushed( 0 ),
+	m_endOfPlayback( 0 ),
+	m_released( false )
+{
+}
+
+
+
+
+SampleStream * SampleStream::create( const QString & file, bool reversed )
+{
+	const f_cnt_t bufferFrames = Engine::audioEngine()->processingSampleRate() * BufferSeconds;
+	SampleStream * stream = new SampleStream( file, reversed, bufferFrames );
+	SampleStreamer::inst().add( stream );
+	return stream;
+}
+
+
+
+
+void SampleStream::release()
+{
+	m_released = true;
+	SampleStreamer::inst().wakeUp();
+}
+
+
+
+
+int SampleStream::start( f_cnt_t from )
+{
+	int playback = ++s_lastPlayback;
+	if( playback == 0 )
+	{
+		playback = ++s_lastPlayback;
+	}
+	m_missed = 0;
+	m_from.store( from, std::memory_order_relaxed );
+	m_playback.store( playback, std::memory_order_release );
+	SampleStreamer::inst().wakeUp();
+	return playback;
+}
+
+
+
+
+void SampleStream::read( int playback, sampleFrame * dst, f_cnt_t frames, bool wait )
+{
+	if( m_playback.load( std::memory_order_relaxed ) != playback )
+	{
+		// another playback took the stream over
+		memset( dst, 0, frames * BYTES_PER_FRAME );
+		return;
+	}
+
+	f_cnt_t done = 0;
+	bool atEnd = false;
+	while( true )
+	{
+		flush();
+		if( m_flushed.load( std::memory_order_relaxed ) == playback )
+		{
+			// checked first, so nothing written before the end is missed
+			atEnd = m_endOfPlayback.load( std::memory_order_acquire ) == playback;
+
+			// catch up with the frames which were played as silence
+			while( m_missed > 0 )
+			{
+				auto data = m_bufferReader.read_max( m_missed );
+				if( data.size() == 0 )
+				{
+					break;
+				}
+				m_missed -= static_cast<f_cnt_t>( data.size() );
+			}
+
+			while( m_missed == 0 && done < frames )
+			{
+				auto data = m_bufferReader.read_max( frames - done );
+				if( data.size() == 0 )
+				{
+					break;
+				}
+				for( std::size_t i = 0; i < data.size(); ++i )
+				{
+					dst[done + i] = data[i];
+				}
+				done += data.size();
+			}
+
+			if( done == frames || atEnd )
+			{
+				break;
+			}
+		}
+
+		if( !wait || m_playback.load( std::memory_order_relaxed ) != playback )
+		{
+			break;
+		}
+		SampleStreamer::inst().wakeUp();
+		std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+	}
+
+	if( done < frames )
+	{
+		memset( dst + done, 0, ( frames - done ) * BYTES_PER_FRAME );
+		if( !atEnd )
+		{
+			// skip them later, so the stream stays in time
+			m_missed += frames - done;
+		}
+	}
+}
+
+
+
+
+void SampleStream::flush()
+{
+	const int request = m_flushRequest.load( std::memory_order_acquire );
+	if( request == m_flushed.load( std::memory_order_relaxed ) )
+	{
+		return;
+	}
+
+	// nothing is written until m_flushed is set, so this empties the buffer
+	std::size_t left;
+	while( ( left = m_bufferReader.read_space() ) > 0 )
+	{
+		m_bufferReader.read_max( left );
+	}
+	m_flushed.store( request, std::memory_order_release );
+	SampleStreamer::inst().wakeUp();
+}
+
+
+
+
+bool SampleStream::fill()
+{
+	const int playback = m_playback.load( std::memory_order_acquire );
+	if( playback == 0 )
+	{
+		return false;
+	}
+
+	if( playback != m_serving )
+	{
+		m_serving = playback;
+		if( !seek( m_from.load( std::memory_order_relaxed ) ) )
+		{
+			m_endOfPlayback.store( playback, std::memory_order_release );
+		}
+		m_flushRequest.store( playback, std::memory_order_release );
+	}
+
+	if( m_flushed.load( std::memory_order_acquire ) != m_serving ||
+		m_endOfPlayback.load( std::memory_order_relaxed ) == m_serving ||
+		m_buffer.free() < static_cast<std::size_t>( ChunkFrames ) )
+	{
+		return false;
+	}
+
+	const f_cnt_t frames = m_fileReader->read( m_chunk.data(), ChunkFrames );
+	m_buffer.write( m_chunk.data(), frames );
+	if( frames < ChunkFrames )
+	{
+		m_endOfPlayback.store( m_serving, std::memory_order_release );
+		return false;
+	}
+	return true;
+}
+
+
+
+
+bool SampleStream::seek( f_cnt_t from )
+{
+	// the file is converted to the current sample rate
+	const sample_rate_t sampleRate = Engine::audioEngine()->processingSampleRate();
+	if( m_fileReader == nullptr || m_fileReaderRate != sampleRate )
+	{
+		m_fileReader = std::make_unique<SampleFileReader>( m_file, m_reversed, sampleRate );
+		m_fileReaderRate = sampleRate;
+	}
+	if( !m_fileReader->isOpen() )
+	{
+		return false;
+	}
+	m_fileReader->seek( from );
+	return true;
+}
+
+
+} // namespace lmms
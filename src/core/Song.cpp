@@ -97,7 +97,7 @@ Song::Song() :
 	m_elapsedBars( 0 ),
 	m_loopRenderCount(1),
 	m_loopRenderRemaining(1),
-	m_oldAutomatedValues()
+	m_automatedModels()
 {
 	for(int i = 0; i < Mode_Count; ++i) m_elapsedMilliSeconds[i] = 0;
 	connect( &m_tempoModel, SIGNAL(dataChanged()),
@@ -339,12 +339,18 @@ void Song::processNextBuffer()
 		if (static_cast<f_cnt_t>(frameOffsetInTick) == 0)
 		{
 			// First frame of tick: process automation and play tracks
-			processAutomations(trackList, getPlayPos(), framesToPlay);
+			processAutomations(trackList, getPlayPos(), frameOffsetInPeriod);
 			for (const auto track : trackList)
 			{
 				track->play(getPlayPos(), framesToPlay, frameOffsetInPeriod, clipNum);
 			}
 		}
+		else if (frameOffsetInPeriod == 0)
+		{
+			// The period starts within a tick, and the automation curves the
+			// models got at its first frame only lasted for the last period
+			continueAutomations(trackList, getPlayPos(), frameOffsetInTick / framesPerTick);
+		}
 
 		// Update frame counters
 		frameOffsetInPeriod += framesToPlay;
@@ -357,12 +363,8 @@ void Song::processNextBuffer()
 }
 
 
-void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, fpp_t)
+TrackContainer* Song::collectAutomations(const TrackList &tracklist, TimePos time)
 {
-	AutomatedValueMap values;
-
-	QSet<const AutomatableModel*> recordedModels;
-
 	TrackContainer* container = this;
 	int clipNum = -1;
 
@@ -380,10 +382,38 @@ void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, fpp
 	}
 		break;
 	default:
-		return;
+		return nullptr;
 	}
 
-	values = container->automatedValuesAt(timeStart, clipNum);
+	for (auto it = m_automatedModels.begin(); it != m_automatedModels.end(); it++)
+	{
+		it->current = false;
+	}
+
+	// later clips override the earlier ones
+	container->visitAutomation(time, clipNum, [this](const AutomationClip* clip, float tick, float endTick)
+	{
+		for (AutomatableModel* model : clip->objects())
+		{
+			AutomatedModel& automated = m_automatedModels[model];
+			automated.clip = clip;
+			automated.tick = tick;
+			automated.endTick = endTick;
+			automated.current = true;
+		}
+	});
+
+	return container;
+}
+
+
+void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, f_cnt_t frameOffsetInPeriod)
+{
+	QSet<const AutomatableModel*> recordedModels;
+
+	TrackContainer* container = collectAutomations(tracklist, timeStart);
+	if (!container) { return; }
+
 	TrackList tracks = container->tracks();
 
 	Track::clipVector clips;
@@ -408,28 +438,58 @@ void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, fpp
 		}
 	}
 
-	// Checks if an automated model stopped being automated by automation clip
-	// so we can move the control back to any connected controller again
-	for (auto it = m_oldAutomatedValues.begin(); it != m_oldAutomatedValues.end(); it++)
+	// The curves let the models render sample exact values until the next
+	// tick, even across clip boundaries and jumps within the period
+	const float ticksPerFrame = 1.0f / Engine::framesPerTick();
+
+	// Apply values
+	for (auto it = m_automatedModels.begin(); it != m_automatedModels.end(); )
 	{
 		AutomatableModel * am = it.key();
-		if (am->controllerConnection() && !values.contains(am))
+		AutomatedModel& automated = it.value();
+
+		if (!automated.current)
+		{
+			// The model stopped being automated by automation clip, so we
+			// can move the control back to any connected controller again
+			if (am->controllerConnection())
+			{
+				am->setUseControllerValue(true);
+			}
+			am->setAutomationCurve(nullptr, 0, 0, frameOffsetInPeriod, ticksPerFrame);
+			it = m_automatedModels.erase(it);
+			continue;
+		}
+
+		if (! recordedModels.contains(am))
+		{
+			const AutomationCurve& curve = automated.clip->playbackCurve();
+			am->setAutomatedValue(curve.valueAt(std::min(automated.tick, automated.endTick), automated.cursor));
+			am->setAutomationCurve(&curve, automated.tick, automated.endTick, frameOffsetInPeriod, ticksPerFrame);
+		}
+		else if (!am->useControllerValue())
 		{
 			am->setUseControllerValue(true);
 		}
+		it++;
 	}
-	m_oldAutomatedValues = values;
+}
 
-	// Apply values
-	for (auto it = values.begin(); it != values.end(); it++)
+
+void Song::continueAutomations(const TrackList &tracklist, TimePos time, float ticksIntoTick)
+{
+	// the clips may have changed since the tick started, so look them up again
+	if (!collectAutomations(tracklist, time)) { return; }
+
+	const float ticksPerFrame = 1.0f / Engine::framesPerTick();
+
+	for (auto it = m_automatedModels.begin(); it != m_automatedModels.end(); it++)
 	{
-		if (! recordedModels.contains(it.key()))
-		{
-			it.key()->setAutomatedValue(it.value());
-		}
-		else if (!it.key()->useControllerValue())
+		// the others are recorded, or were just added and are handled at the next tick
+		if (it->current && !it.key()->useControllerValue())
 		{
-			it.key()->setUseControllerValue(true);
+			it.key()->setAutomationCurve(&it->clip->playbackCurve(), it->tick + ticksIntoTick,
+							it->endTick, 0, ticksPerFrame);
 		}
 	}
 }
@@ -694,12 +754,12 @@ void Song::stop()
 
 	// Moves the control of the models that were processed on the last frame
 	// back to their controllers.
-	for (auto it = m_oldAutomatedValues.begin(); it != m_oldAutomatedValues.end(); it++)
+	for (auto it = m_automatedModels.begin(); it != m_automatedModels.end(); it++)
 	{
 		AutomatableModel * am = it.key();
 		am->setUseControllerValue(true);
 	}
-	m_oldAutomatedValues.clear();
+	m_automatedModels.clear();
 
 	m_playMode = Mode_None;
 
@@ -846,9 +906,9 @@ AutomationClip * Song::tempoAutomationClip()
 }
 
 
-AutomatedValueMap Song::automatedValuesAt(TimePos time, int clipNum) const
+void Song::visitAutomation(TimePos time, int clipNum, const AutomationVisitor& visit) const
 {
-	return TrackContainer::automatedValuesFromTracks(TrackList{m_globalAutomationTrack} << tracks(), time, clipNum);
+	TrackContainer::visitAutomationOfTracks(TrackList{m_globalAutomationTrack} << tracks(), time, clipNum, visit);
 }
 
 
@@ -906,8 +966,8 @@ void Song::clearProject()
 	m_masterPitchModel.reset();
 	m_timeSigModel.reset();
 
-	// Clear the m_oldAutomatedValues AutomatedValueMap
-	m_oldAutomatedValues.clear();
+	// Clear the automated models of the last tick
+	m_automatedModels.clear();
 
 	AutomationClip::globalAutomationClip( &m_tempoModel )->clear();
 	AutomationClip::globalAutomationClip( &m_masterVolumeModel )->
@@ -65,6 +65,8 @@ Track::Track( TrackTypes type, TrackContainer * tc ) :
 	m_soloModel( false, this, tr( "Solo" ) ), /*!< For controlling track soloing */
 	m_simpleSerializingMode( false ),
 	m_clips(),        /*!< The clips (segments) */
+	m_clipIndexValid( false ),
+	m_clipIndexUpdatePending( false ),
 	m_color( 0, 0, 0 ),
 	m_hasColor( false )
 {
@@ -335,6 +337,7 @@ void Track::loadSettings( const QDomElement & element )
 Clip * Track::addClip( Clip * clip )
 {
 	m_clips.push_back( clip );
+	clipPositionChanged();
 
 	emit clipAdded( clip );
 
@@ -354,6 +357,7 @@ void Track::removeClip( Clip * clip )
 	if( it != m_clips.end() )
 	{
 		m_clips.erase( it );
+		clipPositionChanged();
 		if( Engine::getSong() )
 		{
 			Engine::getSong()->updateLength();
@@ -442,6 +446,9 @@ int Track::getClipNum( const Clip * clip )
  *  the given time period.
  *
  *  We return the Clips we find in order by time, earliest Clips first.
+ *  The search goes through m_clipIndex, so it only costs time for the
+ *  Clips it finds, not for all the Clips of the track. Right after a
+ *  change, we check every Clip until the index has been updated.
  *
  *  \param clipV The list to contain the found clips.
  *  \param start The MIDI start time of the range.
@@ -450,6 +457,12 @@ int Track::getClipNum( const Clip * clip )
 void Track::getClipsInRange( clipVector & clipV, const TimePos & start,
 							const TimePos & end )
 {
+	if( m_clipIndexValid.load( std::memory_order_acquire ) )
+	{
+		m_clipIndex.clipsInRange( clipV, start, end );
+		return;
+	}
+
 	for( Clip* clip : m_clips )
 	{
 		int s = clip->startPosition();
@@ -467,6 +480,41 @@ void Track::getClipsInRange( clipVector & clipV, const TimePos & start,
 
 
 
+/*! \brief Mark the index of the clips as outdated
+ *
+ *  Building the index allocates, which the audio thread must not do, so
+ *  it's rebuilt here once the current batch of changes is done, e.g. after
+ *  all clips of a project have been loaded.
+ */
+void Track::clipPositionChanged()
+{
+	m_clipIndexValid.store( false, std::memory_order_release );
+	if( !m_clipIndexUpdatePending.exchange( true ) )
+	{
+		QMetaObject::invokeMethod( this, "updateClipIndex", Qt::QueuedConnection );
+	}
+}
+
+
+
+
+void Track::updateClipIndex()
+{
+	m_clipIndexUpdatePending = false;
+	ClipIndex index( m_clips );
+
+	Engine::audioEngine()->requestChangeInModel();
+	m_clipIndex.swap( index );
+	// if there were changes meanwhile, another update is on its way
+	m_clipIndexValid.store( !m_clipIndexUpdatePending, std::memory_order_release );
+	Engine::audioEngine()->doneChangeInModel();
+
+	// the old index is released here, outside of the audio thread
+}
+
+
+
+
 /*! \brief Swap the position of two clips.
  *
  *  First, we arrange to swap the positions of the two Clips in the
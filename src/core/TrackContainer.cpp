@@ -29,6 +29,8 @@
 #include <QDomElement>
 #include <QWriteLocker>
 
+#include <limits>
+
 #include "AutomationClip.h"
 #include "embed.h"
 #include "TrackContainer.h"
@@ -253,11 +255,31 @@ bool TrackContainer::isEmpty() const
 
 AutomatedValueMap TrackContainer::automatedValuesAt(TimePos time, int clipNum) const
 {
-	return automatedValuesFromTracks(tracks(), time, clipNum);
+	AutomatedValueMap valueMap;
+
+	visitAutomation(time, clipNum, [&valueMap](const AutomationClip* clip, float tick, float endTick)
+	{
+		const float value = clip->valueAt(static_cast<int>(std::min(tick, endTick)));
+		for (AutomatableModel* model : clip->objects())
+		{
+			valueMap[model] = value;
+		}
+	});
+
+	return valueMap;
 }
 
 
-AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tracks, TimePos time, int clipNum)
+
+
+void TrackContainer::visitAutomation(TimePos time, int clipNum, const AutomationVisitor& visit) const
+{
+	visitAutomationOfTracks(tracks(), time, clipNum, visit);
+}
+
+
+void TrackContainer::visitAutomationOfTracks(const TrackList &tracks, TimePos time, int clipNum,
+						const AutomationVisitor& visit)
 {
 	Track::clipVector clips;
 
@@ -283,8 +305,6 @@ AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tra
 		}
 	}
 
-	AutomatedValueMap valueMap;
-
 	Q_ASSERT(std::is_sorted(clips.begin(), clips.end(), Clip::comparePosition));
 
 	for(Clip* clip : clips)
@@ -299,15 +319,12 @@ AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tra
 				continue;
 			}
 			TimePos relTime = time - p->startPosition();
+			float endTick = std::numeric_limits<float>::max();
 			if (! p->getAutoResize()) {
 				relTime = qMin(relTime, p->length());
+				endTick = p->length();
 			}
-			float value = p->valueAt(relTime);
-
-			for (AutomatableModel* model : p->objects())
-			{
-				valueMap[model] = value;
-			}
+			visit(p, static_cast<float>(relTime), endTick);
 		}
 		else if (auto* pattern = dynamic_cast<PatternClip*>(clip))
 		{
@@ -315,24 +332,25 @@ AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tra
 			auto patStore = Engine::patternStore();
 
 			TimePos patTime = time - clip->startPosition();
+			// after the end of the pattern clip, its automation stays where it ended
+			const bool ended = patTime >= clip->length();
 			patTime = std::min(patTime, clip->length());
 			patTime = patTime % (patStore->lengthOfPattern(patIndex) * TimePos::ticksPerBar());
 
-			auto patValues = patStore->automatedValuesAt(patTime, patIndex);
-			for (auto it=patValues.begin(); it != patValues.end(); it++)
-			{
-				// override old values, pattern track with the highest index takes precedence
-				valueMap[it.key()] = it.value();
-			}
+			// visited after the clips before it, so the pattern track with
+			// the highest index takes precedence
+			patStore->visitAutomation(patTime, patIndex,
+				[&visit, ended](const AutomationClip* p, float tick, float endTick)
+				{
+					visit(p, tick, ended ? tick : endTick);
+				});
 		}
 		else
 		{
 			continue;
 		}
 	}
-
-	return valueMap;
-};
+}
 
 
 } // namespace lmms
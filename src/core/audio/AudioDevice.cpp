@@ -104,11 +104,6 @@ fpp_t AudioDevice::getNextBuffer( surroundSampleFrame * _ab )
 	// release lock
 	unlock();
 
-	if( audioEngine()->hasFifoWriter() )
-	{
-		delete[] b;
-	}
-
 	return frames;
 }
 
@@ -24,21 +24,56 @@
  */
 
 #include <QMessageBox>
+#include <QThread>
 
 #include "AudioFileDevice.h"
+#include "AudioEngine.h"
 #include "ExportProjectDialog.h"
 #include "GuiApplication.h"
+#include "MemoryManager.h"
 
 namespace lmms
 {
 
+// number of blocks in the pool, i.e. how far the encoder may fall behind
+static const int EncoderBlocks = 8;
+
+// periods are collected until a block holds about this many frames
+static const int EncoderBlockFrames = 8192;
+
+
+class AudioFileDevice::EncoderThread : public QThread
+{
+public:
+	EncoderThread( AudioFileDevice * device ) :
+		m_device( device )
+	{
+	}
+
+private:
+	void run() override
+	{
+		MemoryManager::ThreadGuard mmThreadGuard; Q_UNUSED(mmThreadGuard);
+		m_device->encodeBlocks();
+	}
+
+	AudioFileDevice * m_device;
+} ;
+
+
+
+
 AudioFileDevice::AudioFileDevice( OutputSettings const & outputSettings,
 					const ch_cnt_t _channels,
 					const QString & _file,
 					AudioEngine*  _audioEngine ) :
 	AudioDevice( _channels, _audioEngine ),
 	m_outputFile( _file ),
-	m_outputSettings(outputSettings)
+	m_outputSettings(outputSettings),
+	m_freeBlocks( EncoderBlocks ),
+	// one more for the end marker
+	m_filledBlocks( EncoderBlocks + 1 ),
+	m_currentBlock( nullptr )
 {
 	using gui::ExportProjectDialog;
 
@@ -75,12 +110,133 @@ AudioFileDevice::AudioFileDevice( OutputSettings const & outputSettings,
 
 AudioFileDevice::~AudioFileDevice()
 {
+	// the encoder calls into the derived class, which is gone by now
+	Q_ASSERT( m_encoder == nullptr );
 	m_outputFile.close();
 }
 
 
 
 
+void AudioFileDevice::startEncoder()
+{
+	if( m_encoder )
+	{
+		return;
+	}
+
+	// whole periods only, and within what fpp_t can hold
+	const fpp_t period = audioEngine()->framesPerPeriod();
+	const int blockFrames = period * qMax( 1, EncoderBlockFrames / period );
+
+	m_blocks.resize( EncoderBlocks );
+	for( Block & block : m_blocks )
+	{
+		block.frames.resize( blockFrames );
+		block.used = 0;
+		block.masterGain = 1.0f;
+		m_freeBlocks.push( &block );
+	}
+	m_freeCount.release( EncoderBlocks );
+
+	m_encoder = std::make_unique<EncoderThread>( this );
+	m_encoder->start();
+}
+
+
+
+
+void AudioFileDevice::queueNextBuffer()
+{
+	const float masterGain = audioEngine()->masterGain();
+	if( m_currentBlock && m_currentBlock->masterGain != masterGain )
+	{
+		pushBlock();
+	}
+
+	if( !m_currentBlock )
+	{
+		// waits if the encoder has fallen too far behind
+		m_freeCount.acquire();
+		m_freeBlocks.pop( m_currentBlock );
+		m_currentBlock->used = 0;
+		m_currentBlock->masterGain = masterGain;
+	}
+
+	// render straight into the block - resampling never makes a period longer
+	const fpp_t frames = getNextBuffer( m_currentBlock->frames.data() + m_currentBlock->used );
+	m_currentBlock->used += frames;
+
+	const int space = static_cast<int>( m_currentBlock->frames.size() ) - m_currentBlock->used;
+	if( space < audioEngine()->framesPerPeriod() )
+	{
+		pushBlock();
+	}
+}
+
+
+
+
+void AudioFileDevice::finishEncoder()
+{
+	if( !m_encoder )
+	{
+		return;
+	}
+
+	if( m_currentBlock && m_currentBlock->used > 0 )
+	{
+		pushBlock();
+	}
+
+	// a null block ends the encoder loop
+	m_filledBlocks.push( nullptr );
+	m_filledCount.release();
+	m_encoder->wait();
+	m_encoder.reset();
+
+	// leave the pool ready for another startEncoder()
+	Block * block;
+	while( m_freeBlocks.pop( block ) ) {}
+	m_freeCount.acquire( m_freeCount.available() );
+	m_currentBlock = nullptr;
+}
+
+
+
+
+void AudioFileDevice::pushBlock()
+{
+	m_filledBlocks.push( m_currentBlock );
+	m_filledCount.release();
+	m_currentBlock = nullptr;
+}
+
+
+
+
+void AudioFileDevice::encodeBlocks()
+{
+	while( true )
+	{
+		m_filledCount.acquire();
+		Block * block = nullptr;
+		m_filledBlocks.pop( block );
+		if( block == nullptr )
+		{
+			break;
+		}
+
+		writeBuffer( block->frames.data(), block->used, block->masterGain );
+
+		m_freeBlocks.push( block );
+		m_freeCount.release();
+	}
+}
+
+
+
+
 int AudioFileDevice::writeData( const void* data, int len )
 {
 	if( m_outputFile.isOpen() )
@@ -25,7 +25,6 @@
 #include <QtGlobal>
 
 #include <cmath>
-#include <memory>
 
 #include "AudioFileFlac.h"
 #include "endian_handling.h"
@@ -96,7 +95,8 @@ void AudioFileFlac::writeBuffer(surroundSampleFrame const* _ab, fpp_t const fram
 
 	if (depth == OutputSettings::Depth_24Bit || depth == OutputSettings::Depth_32Bit) // Float encoding
 	{
-		std::unique_ptr<sample_t[]> buf{ new sample_t[frames*channels()] };
+		m_floatBuffer.resize(frames * channels());
+		sample_t* buf = m_floatBuffer.data();
 		for(fpp_t frame = 0; frame < frames; ++frame)
 		{
 			for(ch_cnt_t channel=0; channel<channels(); ++channel)
@@ -107,13 +107,13 @@ void AudioFileFlac::writeBuffer(surroundSampleFrame const* _ab, fpp_t const fram
 				buf[frame*channels() + channel] = qMax( clipvalue, _ab[frame][channel] * master_gain );
 			}
 		}
-		sf_writef_float(m_sf,static_cast<float*>(buf.get()),frames);
+		sf_writef_float(m_sf, buf, frames);
 	}
 	else // integer PCM encoding
 	{
-		std::unique_ptr<int_sample_t[]> buf{ new int_sample_t[frames*channels()] };
-		convertToS16(_ab, frames, master_gain, buf.get(), !isLittleEndian());
-		sf_writef_short(m_sf, static_cast<short*>(buf.get()), frames);
+		m_intBuffer.resize(frames * channels());
+		convertToS16(_ab, frames, master_gain, m_intBuffer.data(), !isLittleEndian());
+		sf_writef_short(m_sf, m_intBuffer.data(), frames);
 	}
 
 }
@@ -41,6 +41,9 @@ AudioPort::AudioPort( const QString & _name, bool _has_effect_chain,
 	m_portBuffer( BufferManager::acquire() ),
 	m_extOutputEnabled( false ),
 	m_nextMixerChannel( 0 ),
+	m_mixOrder( 0 ),
+	m_sourceLatency( 0 ),
+	m_compensationDelay(),
 	m_name( "unnamed port" ),
 	m_effects( _has_effect_chain ? new EffectChain( nullptr ) : nullptr ),
 	m_volumeModel( volumeModel ),
@@ -83,6 +86,46 @@ void AudioPort::setExtOutputEnabled( bool _enabled )
 
 
 
+void AudioPort::setNextMixerChannel( const mix_ch_t _chnl )
+{
+	m_nextMixerChannel = _chnl;
+	requestLatencyUpdate();
+}
+
+
+
+
+void AudioPort::setSourceLatency( f_cnt_t frames )
+{
+	if( m_sourceLatency.exchange( frames ) != frames )
+	{
+		requestLatencyUpdate();
+	}
+}
+
+
+
+
+f_cnt_t AudioPort::latency() const
+{
+	return m_sourceLatency + ( m_effects ? m_effects->latency() : 0 );
+}
+
+
+
+
+void AudioPort::requestLatencyUpdate()
+{
+	// ports may outlive the mixer on shutdown
+	if( Engine::mixer() )
+	{
+		Engine::mixer()->requestLatencyUpdate();
+	}
+}
+
+
+
+
 void AudioPort::setName( const QString & _name )
 {
 	m_name = _name;
@@ -141,53 +184,28 @@ void AudioPort::doProcessing()
 			ValueBuffer * volBuf = m_volumeModel->valueBuffer();
 			ValueBuffer * panBuf = m_panningModel->valueBuffer();
 
-			// both vol and pan have s.ex.data:
-			if( volBuf && panBuf )
+			// pan has s.ex.data, vol may have:
+			if( panBuf )
 			{
-				for( f_cnt_t f = 0; f < fpp; ++f )
-				{
-					float v = volBuf->values()[ f ] * 0.01f;
-					float p = panBuf->values()[ f ] * 0.01f;
-					m_portBuffer[f][0] *= ( p <= 0 ? 1.0f : 1.0f - p ) * v;
-					m_portBuffer[f][1] *= ( p >= 0 ? 1.0f : 1.0f + p ) * v;
-				}
+				const float v = volBuf ? 0.01f : m_volumeModel->value() * 0.01f;
+				MixHelpers::multiplyByPanningBuffer( m_portBuffer, volBuf, v, panBuf, 0.01f, fpp );
 			}
-
-			// only vol has s.ex.data:
-			else if( volBuf )
+			else
 			{
 				float p = m_panningModel->value() * 0.01f;
 				float l = ( p <= 0 ? 1.0f : 1.0f - p );
 				float r = ( p >= 0 ? 1.0f : 1.0f + p );
-				for( f_cnt_t f = 0; f < fpp; ++f )
-				{
-					float v = volBuf->values()[ f ] * 0.01f;
-					m_portBuffer[f][0] *= v * l;
-					m_portBuffer[f][1] *= v * r;
-				}
-			}
 
-			// only pan has s.ex.data:
-			else if( panBuf )
-			{
-				float v = m_volumeModel->value() * 0.01f;
-				for( f_cnt_t f = 0; f < fpp; ++f )
+				// only vol has s.ex.data:
+				if( volBuf )
 				{
-					float p = panBuf->values()[ f ] * 0.01f;
-					m_portBuffer[f][0] *= ( p <= 0 ? 1.0f : 1.0f - p ) * v;
-					m_portBuffer[f][1] *= ( p >= 0 ? 1.0f : 1.0f + p ) * v;
+					MixHelpers::multiplyByBuffer( m_portBuffer, volBuf, l * 0.01f, r * 0.01f, fpp );
 				}
-			}
-
-			// neither has s.ex.data:
-			else
-			{
-				float p = m_panningModel->value() * 0.01f;
-				float v = m_volumeModel->value() * 0.01f;
-				for( f_cnt_t f = 0; f < fpp; ++f )
+				// neither has s.ex.data:
+				else
 				{
-					m_portBuffer[f][0] *= ( p <= 0 ? 1.0f : 1.0f - p ) * v;
-					m_portBuffer[f][1] *= ( p >= 0 ? 1.0f : 1.0f + p ) * v;
+					float v = m_volumeModel->value() * 0.01f;
+					MixHelpers::multiply( m_portBuffer, l * v, r * v, fpp );
 				}
 			}
 		}
@@ -199,21 +217,12 @@ void AudioPort::doProcessing()
 
 			if( volBuf )
 			{
-				for( f_cnt_t f = 0; f < fpp; ++f )
-				{
-					float v = volBuf->values()[ f ] * 0.01f;
-					m_portBuffer[f][0] *= v;
-					m_portBuffer[f][1] *= v;
-				}
+				MixHelpers::multiplyByBuffer( m_portBuffer, volBuf, 0.01f, 0.01f, fpp );
 			}
 			else
 			{
 				float v = m_volumeModel->value() * 0.01f;
-				for( f_cnt_t f = 0; f < fpp; ++f )
-				{
-					m_portBuffer[f][0] *= v;
-					m_portBuffer[f][1] *= v;
-				}
+				MixHelpers::multiply( m_portBuffer, v, v, fpp );
 			}
 		}
 	}
@@ -222,9 +231,13 @@ void AudioPort::doProcessing()
 
 	// handle effects
 	const bool me = processEffects();
-	if( me || m_bufferUsage )
+
+	// line up with the other, possibly slower, inputs of the mixer channel
+	m_compensationDelay.process( m_portBuffer, fpp, me || m_bufferUsage );
+
+	if( me || m_bufferUsage || m_compensationDelay.hasTail() )
 	{
-		Engine::mixer()->mixToChannel( m_portBuffer, m_nextMixerChannel ); 	// send output to mixer
+		Engine::mixer()->mixToChannel( m_portBuffer, m_nextMixerChannel, m_mixOrder ); 	// send output to mixer
 																			// TODO: improve the flow here - convert to pull model
 		m_bufferUsage = false;
 	}
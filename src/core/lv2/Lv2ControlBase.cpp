@@ -30,15 +30,35 @@
 #include <QDebug>
 #include <QtGlobal>
 
+#include "AudioEngineWorkerThread.h"
 #include "Engine.h"
 #include "Lv2Manager.h"
 #include "Lv2Proc.h"
+#include "ThreadableJob.h"
 
 
 namespace lmms
 {
 
 
+class Lv2ControlBase::RunJob : public ThreadableJob
+{
+public:
+	RunJob(Lv2Proc* proc) : m_proc(proc) {}
+
+	void setFrames(fpp_t frames) { m_frames = frames; }
+	bool requiresProcessing() const override { return true; }
+
+private:
+	void doProcessing() override { m_proc->run(m_frames); }
+
+	Lv2Proc* m_proc;
+	fpp_t m_frames = 0;
+};
+
+
+
+
 Plugin::PluginTypes Lv2ControlBase::check(const LilvPlugin *plugin,
 	std::vector<PluginIssue> &issues)
 {
@@ -77,6 +97,10 @@ Lv2ControlBase::Lv2ControlBase(Model* that, const QString &uri) :
 		{
 			m_channelsPerProc = DEFAULT_CHANNELS / m_procs.size();
 			linkAllModels();
+			for (std::size_t i = 1; i < m_procs.size(); ++i)
+			{
+				m_runJobs.push_back(std::make_unique<RunJob>(m_procs[i].get()));
+			}
 		}
 	}
 	else
@@ -148,7 +172,20 @@ void Lv2ControlBase::copyBuffersToLmms(sampleFrame *buf, fpp_t frames) const {
 
 
 void Lv2ControlBase::run(fpp_t frames) {
-	for (auto& c : m_procs) { c->run(frames); }
+	if (m_procs.empty()) { return; }
+
+	// the instances don't share any data, so e.g. the two processors of a
+	// mono plugin can run on different cores
+	for (auto& job : m_runJobs)
+	{
+		job->setFrames(frames);
+		AudioEngineWorkerThread::addJob(job.get());
+	}
+	m_procs[0]->run(frames);
+	for (auto& job : m_runJobs)
+	{
+		AudioEngineWorkerThread::waitForJob(job.get());
+	}
 }
 
 
@@ -208,6 +245,16 @@ bool Lv2ControlBase::hasNoteInput() const
 
 
 
+f_cnt_t Lv2ControlBase::reportedLatency() const
+{
+	f_cnt_t res = 0;
+	for (const auto& c : m_procs) { res = std::max(res, c->latency()); }
+	return res;
+}
+
+
+
+
 void Lv2ControlBase::handleMidiInputEvent(const MidiEvent &event,
 	const TimePos &time, f_cnt_t offset)
 {
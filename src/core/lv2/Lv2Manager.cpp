@@ -32,6 +32,7 @@
 #include <lilv/lilv.h>
 #include <lv2/lv2plug.in/ns/ext/buf-size/buf-size.h>
 #include <lv2/lv2plug.in/ns/ext/options/options.h>
+#include <lv2/lv2plug.in/ns/ext/worker/worker.h>
 #include <QDebug>
 #include <QElapsedTimer>
 
@@ -150,6 +151,8 @@ Lv2Manager::Lv2Manager() :
 	m_supportedFeatureURIs.insert(LV2_BUF_SIZE__boundedBlockLength);
 	// block length is only changed initially in AudioEngine CTOR
 	m_supportedFeatureURIs.insert(LV2_BUF_SIZE__fixedBlockLength);
+	// provided by Lv2Proc for plugins which want it
+	m_supportedFeatureURIs.insert(LV2_WORKER__schedule);
 
 	auto supportOpt = [this](Lv2UridCache::Id id)
 	{
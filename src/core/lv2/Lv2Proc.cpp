@@ -26,10 +26,12 @@
 
 #ifdef LMMS_HAVE_LV2
 
+#include <algorithm>
 #include <cmath>
 #include <lv2/lv2plug.in/ns/ext/midi/midi.h>
 #include <lv2/lv2plug.in/ns/ext/atom/atom.h>
 #include <lv2/lv2plug.in/ns/ext/resize-port/resize-port.h>
+#include <lv2/lv2plug.in/ns/ext/worker/worker.h>
 #include <QDebug>
 #include <QtGlobal>
 
@@ -188,7 +190,9 @@ void Lv2Proc::dumpPorts()
 
 
 
-void Lv2Proc::copyModelsFromCore()
+//! Value of a connected model as the plugin expects it
+static float floatFromModel(const AutomatableModel& model,
+	const std::vector<float>& scalePointMap)
 {
 	struct FloatFromModelVisitor : public ConstModelVisitor
 	{
@@ -203,22 +207,54 @@ void Lv2Proc::copyModelsFromCore()
 			m_res = (*m_scalePointMap)[static_cast<std::size_t>(m.value())]; }
 	};
 
+	FloatFromModelVisitor ffm;
+	ffm.m_scalePointMap = &scalePointMap;
+	model.accept(ffm);
+	return ffm.m_res;
+}
+
+
+
+
+void Lv2Proc::copyModelsFromCore()
+{
 	struct Copy : public Lv2Ports::Visitor
 	{
-		void visit(Lv2Ports::Control& ctrl) override
-		{
-			FloatFromModelVisitor ffm;
-			ffm.m_scalePointMap = &ctrl.m_scalePointMap;
-			ctrl.m_connectedModel->accept(ffm);
-			ctrl.m_val = ffm.m_res;
-		}
 		void visit(Lv2Ports::Cv& cv) override
 		{
-			FloatFromModelVisitor ffm;
-			ffm.m_scalePointMap = &cv.m_scalePointMap;
-			cv.m_connectedModel->accept(ffm);
-			// dirty fix, needs better interpolation
-			std::fill(cv.m_buffer.begin(), cv.m_buffer.end(), ffm.m_res);
+			float* buf = cv.m_buffer.data();
+			const std::size_t frames = cv.m_buffer.size();
+			if (const ValueBuffer* vb = cv.m_connectedModel->valueBuffer())
+			{
+				// sample exact controllers or automation
+				const std::size_t n = std::min(frames,
+					static_cast<std::size_t>(vb->length()));
+				std::copy_n(vb->values(), n, buf);
+				std::fill(buf + n, buf + frames, n ? buf[n - 1] : cv.m_lastVal);
+				cv.m_lastVal = buf[frames - 1];
+				cv.m_constant = false;
+				return;
+			}
+
+			const float val = cv.m_connectedModel->value<float>();
+			if (val != cv.m_lastVal)
+			{
+				// ramp from the last value, ending exactly on the new one
+				const float start = cv.m_lastVal;
+				const float step = (val - start) / frames;
+				for (std::size_t f = 0; f < frames; ++f)
+				{
+					buf[f] = start + step * (f + 1);
+				}
+				cv.m_lastVal = val;
+				cv.m_constant = false;
+			}
+			else if (!cv.m_constant)
+			{
+				std::fill(buf, buf + frames, val);
+				cv.m_constant = true;
+			}
+			// else: the buffer still holds val
 		}
 		void visit(Lv2Ports::AtomSeq& atomPort) override
 		{
@@ -226,15 +262,23 @@ void Lv2Proc::copyModelsFromCore()
 		}
 	} copy;
 
-	// feed each input port with the respective data from the LMMS core
-	for (const std::unique_ptr<Lv2Ports::PortBase>& port : m_ports)
+	// most periods, no control changes, so don't even look at the models
+	// reset before reading, so changes made meanwhile are seen next period
+	if (m_controlsChanged.exchange(false))
 	{
-		if (port->m_flow == Lv2Ports::Flow::Input)
+		for (Lv2Ports::Control* ctrl : m_controlInputs)
 		{
-			port->accept(copy);
+			ctrl->m_val = floatFromModel(*ctrl->m_connectedModel,
+				ctrl->m_scalePointMap);
 		}
 	}
 
+	// feed the other input ports with the respective data from the LMMS core
+	for (Lv2Ports::PortBase* port : m_otherInputs)
+	{
+		port->accept(copy);
+	}
+
 	// send pending MIDI events to atom port
 	if(m_midiIn)
 	{
@@ -331,7 +375,16 @@ void Lv2Proc::copyBuffersToCore(sampleFrame* buf,
 
 void Lv2Proc::run(fpp_t frames)
 {
+	if (m_worker)
+	{
+		// answers to work scheduled in earlier runs
+		m_worker->emitResponses();
+	}
 	lilv_instance_run(m_instance, static_cast<uint32_t>(frames));
+	if (m_worker)
+	{
+		m_worker->notifyEndOfRun();
+	}
 }
 
 
@@ -399,6 +452,13 @@ void Lv2Proc::initPlugin()
 
 	if (m_instance)
 	{
+		if (m_worker)
+		{
+			m_worker->setInstance(lilv_instance_get_handle(m_instance),
+				static_cast<const LV2_Worker_Interface*>(
+					lilv_instance_get_extension_data(m_instance,
+						LV2_WORKER__interface)));
+		}
 		for (std::size_t portNum = 0; portNum < m_ports.size(); ++portNum)
 			connectPort(portNum);
 		lilv_instance_activate(m_instance);
@@ -419,6 +479,8 @@ void Lv2Proc::initPlugin()
 
 void Lv2Proc::shutdownPlugin()
 {
+	// wait for work in progress while the instance is still alive
+	m_worker.reset();
 	if (m_valid)
 	{
 		lilv_instance_deactivate(m_instance);
@@ -430,6 +492,16 @@ void Lv2Proc::shutdownPlugin()
 
 
 
+f_cnt_t Lv2Proc::latency() const
+{
+	return m_latencyPort
+		? static_cast<f_cnt_t>(m_latencyPort->m_val)
+		: 0;
+}
+
+
+
+
 bool Lv2Proc::hasNoteInput() const
 {
 	return m_midiIn;
@@ -474,6 +546,12 @@ void Lv2Proc::initPluginSpecificFeatures()
 {
 	initMOptions();
 	m_features[LV2_OPTIONS__options] = const_cast<LV2_Options_Option*>(m_options.feature());
+
+	if (lilv_plugin_has_feature(m_plugin, uri(LV2_WORKER__schedule).get()))
+	{
+		m_worker = std::make_unique<Lv2Worker>();
+		m_features[LV2_WORKER__schedule] = m_worker->feature();
+	}
 }
 
 
@@ -487,6 +565,27 @@ void Lv2Proc::loadFileInternal(const QString &file)
 
 
 
+//! Model for a port without special visualization
+static FloatModel* createFloatModel(const Lv2Ports::Meta& meta,
+	const QString& dispName)
+{
+	sample_rate_t sr = Engine::audioEngine()->processingSampleRate();
+
+	// allow ~1000 steps
+	float stepSize = (meta.max(sr) - meta.min(sr)) / 1000.0f;
+
+	// make multiples of 0.01 (or 0.1 for larger values)
+	float minStep = (stepSize >= 1.0f) ? 0.1f : 0.01f;
+	stepSize -= fmodf(stepSize, minStep);
+	stepSize = std::max(stepSize, minStep);
+
+	return new FloatModel(meta.def(), meta.min(sr), meta.max(sr),
+		stepSize, nullptr, dispName);
+}
+
+
+
+
 void Lv2Proc::createPort(std::size_t portNum)
 {
 	Lv2Ports::Meta meta;
@@ -519,20 +618,9 @@ void Lv2Proc::createPort(std::size_t portNum)
 				switch (meta.m_vis)
 				{
 					case Lv2Ports::Vis::Generic:
-					{
-						// allow ~1000 steps
-						float stepSize = (meta.max(sr) - meta.min(sr)) / 1000.0f;
-
-						// make multiples of 0.01 (or 0.1 for larger values)
-						float minStep = (stepSize >= 1.0f) ? 0.1f : 0.01f;
-						stepSize -= fmodf(stepSize, minStep);
-						stepSize = std::max(stepSize, minStep);
-
 						ctrl->m_connectedModel.reset(
-							new FloatModel(meta.def(), meta.min(sr), meta.max(sr),
-											stepSize, nullptr, dispName));
+							createFloatModel(meta, dispName));
 						break;
-					}
 					case Lv2Ports::Vis::Integer:
 						ctrl->m_connectedModel.reset(
 							new IntModel(static_cast<int>(meta.def()),
@@ -573,9 +661,37 @@ void Lv2Proc::createPort(std::size_t portNum)
 				}
 
 			} // if m_flow == Input
+			else if (lilv_port_has_property(m_plugin, lilvPort,
+						uri(LV2_CORE__reportsLatency).get()))
+			{
+				m_latencyPort = ctrl;
+			}
 			port = ctrl;
 			break;
 		}
+		case Lv2Ports::Type::Cv:
+		{
+			Lv2Ports::Cv* cv = new Lv2Ports::Cv;
+			cv->m_buffer.resize(static_cast<std::size_t>(
+				Engine::audioEngine()->framesPerPeriod()));
+			if (meta.m_flow == Lv2Ports::Flow::Input)
+			{
+				// CV is continuous, so integer or enumeration hints are not
+				// worth a special model
+				AutoLilvNode node(lilv_port_get_name(m_plugin, lilvPort));
+				cv->m_connectedModel.reset(createFloatModel(meta,
+					lilv_node_as_string(node.get())));
+				if(meta.m_logarithmic)
+				{
+					cv->m_connectedModel->setScaleLogarithmic();
+				}
+				cv->m_lastVal = cv->m_connectedModel->value<float>();
+				std::fill(cv->m_buffer.begin(), cv->m_buffer.end(), cv->m_lastVal);
+				cv->m_constant = true;
+			}
+			port = cv;
+			break;
+		}
 		case Lv2Ports::Type::Audio:
 		{
 			Lv2Ports::Audio* audio =
@@ -662,6 +778,26 @@ void Lv2Proc::createPorts()
 										m_proc->m_plugin, ctrl.m_port)),
 					amo);
 				m_proc->addModel(amo, ctrl.uri());
+				m_proc->m_controlInputs.push_back(&ctrl);
+				// linked models forward dataChanged(), so this also
+				// covers models changed by controllers of linked ones
+				QObject::connect(amo, &Model::dataChanged, m_proc,
+					[proc = m_proc] { proc->m_controlsChanged = true; },
+					Qt::DirectConnection);
+			}
+		}
+
+		void visit(Lv2Ports::Cv& cv) override
+		{
+			if (cv.m_flow == Lv2Ports::Flow::Input)
+			{
+				AutomatableModel* amo = cv.m_connectedModel.get();
+				m_proc->m_connectedModels.emplace(
+					lilv_node_as_string(lilv_port_get_symbol(
+										m_proc->m_plugin, cv.m_port)),
+					amo);
+				m_proc->addModel(amo, cv.uri());
+				m_proc->m_otherInputs.push_back(&cv);
 			}
 		}
 
@@ -692,6 +828,7 @@ void Lv2Proc::createPorts()
 		{
 			if(atomPort.m_flow == Lv2Ports::Flow::Input)
 			{
+				m_proc->m_otherInputs.push_back(&atomPort);
 				if(atomPort.flags & Lv2Ports::AtomSeq::FlagType::Midi)
 				{
 					// take any MIDI input, prefer mandatory MIDI input
@@ -718,6 +855,10 @@ void Lv2Proc::createPorts()
 
 	std::size_t maxPorts = lilv_plugin_get_num_ports(m_plugin);
 	m_ports.resize(maxPorts);
+	m_latencyPort = nullptr;
+	m_controlInputs.clear();
+	m_otherInputs.clear();
+	m_controlsChanged = true;
 
 	for (std::size_t portNum = 0; portNum < maxPorts; ++portNum)
 	{
@@ -751,6 +892,7 @@ struct ConnectPortVisitor : public Lv2Ports::Visitor
 		connectPort(lv2_evbuf_get_buffer(atomSeq.m_buf.get()));
 	}
 	void visit(Lv2Ports::Control& ctrl) override { connectPort(&ctrl.m_val); }
+	void visit(Lv2Ports::Cv& cv) override { connectPort(cv.m_buffer.data()); }
 	void visit(Lv2Ports::Audio& audio) override
 	{
 		connectPort((audio.mustBeUsed()) ? audio.m_buffer.data() : nullptr);
@@ -784,6 +926,10 @@ void Lv2Proc::dumpPort(std::size_t num)
 				qDebug() << "    value:" << ctrl.m_val;
 			}
 		}
+		void visit(const Lv2Ports::Cv& cv) override {
+			qDebug() << "  cv port";
+			qDebug() << "    buffer size:" << cv.m_buffer.size();
+		}
 		void visit(const Lv2Ports::Audio& audio) override {
 			qDebug() << (audio.isSideChain()	? "  audio port (sidechain)"
 												: "  audio port");
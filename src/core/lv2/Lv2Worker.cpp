@@ -0,0 +1,313 @@
+/*
+ * Lv2Worker.cpp - Lv2Worker implementation
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Lv2Worker.h"
+
+#ifdef LMMS_HAVE_LV2
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Engine.h"
+#include "Song.h"
+
+
+namespace lmms
+{
+
+
+namespace
+{
+
+//! size of each ringbuffer in bytes, messages are usually file names or pointers
+constexpr std::size_t RingSize = 1 << 16;
+//! maximum wait time, in case a wake up is missed
+constexpr auto PollInterval = std::chrono::milliseconds(10);
+
+}
+
+
+
+
+//! The threads doing the work for all Lv2Worker instances. The audio threads
+//! hand workers over through a lock-free list. A worker is handled by at most
+//! one thread at a time, since plugins need not expect concurrent work() calls.
+class Lv2WorkerPool
+{
+public:
+	static Lv2WorkerPool& inst()
+	{
+		static Lv2WorkerPool pool;
+		return pool;
+	}
+
+	//! Realtime safe
+	void schedule(Lv2Worker* worker)
+	{
+		if (worker->m_scheduled.exchange(true)) { return; }
+
+		worker->m_next = m_incoming.load(std::memory_order_relaxed);
+		while (!m_incoming.compare_exchange_weak(worker->m_next, worker,
+				std::memory_order_release, std::memory_order_relaxed)) {}
+		m_condition.notify_one();
+	}
+
+private:
+	Lv2WorkerPool()
+	{
+		// the work is mostly loading files, so a few threads are enough
+		const unsigned count = std::max(1u,
+			std::min(4u, std::thread::hardware_concurrency() / 2));
+		for (unsigned i = 0; i < count; ++i)
+		{
+			m_threads.emplace_back([this] { run(); });
+		}
+	}
+
+	~Lv2WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_condition.notify_all();
+		for (std::thread& thread : m_threads) { thread.join(); }
+	}
+
+	//! Move the workers from the lock-free list to m_queue, in order
+	void adoptIncoming()
+	{
+		Lv2Worker* worker = m_incoming.exchange(nullptr, std::memory_order_acquire);
+		const auto pos = m_queue.size();
+		for (; worker; worker = worker->m_next)
+		{
+			m_queue.insert(m_queue.begin() + pos, worker);
+		}
+	}
+
+	void run()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (!m_quit)
+		{
+			adoptIncoming();
+			if (m_queue.empty())
+			{
+				m_condition.wait_for(lock, PollInterval);
+				continue;
+			}
+
+			Lv2Worker* worker = m_queue.front();
+			m_queue.pop_front();
+			worker->m_busy = true;
+			lock.unlock();
+
+			while (true)
+			{
+				worker->work();
+				worker->m_scheduled = false;
+				// a request may have arrived after work() was done, but
+				// before m_scheduled was reset, so it was not scheduled again.
+				// Take it back then, unless someone else scheduled it.
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (worker->m_requestReader.read_space() == 0
+					|| worker->m_scheduled.exchange(true)) { break; }
+			}
+			// the worker may be destroyed from here on
+			worker->m_busy = false;
+
+			lock.lock();
+		}
+	}
+
+	std::atomic<Lv2Worker*> m_incoming{nullptr};
+	std::deque<Lv2Worker*> m_queue;
+	bool m_quit = false;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::vector<std::thread> m_threads;
+};
+
+
+
+
+Lv2Worker::Lv2Worker() :
+	m_requests(RingSize),
+	m_requestReader(m_requests),
+	m_responses(RingSize),
+	m_responseReader(m_responses),
+	m_requestBuf(RingSize),
+	m_responseBuf(RingSize),
+	m_requestScratch(RingSize),
+	m_responseScratch(RingSize),
+	m_scheduled(false),
+	m_busy(false)
+{
+	m_schedule.handle = this;
+	m_schedule.schedule_work = staticScheduleWork;
+	m_requests.touch();
+	m_responses.touch();
+}
+
+
+
+
+Lv2Worker::~Lv2Worker()
+{
+	// the pool might still work on or for us. m_scheduled is checked first,
+	// as the pool only resets it while m_busy is set.
+	while (m_scheduled || m_busy)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+
+
+
+void Lv2Worker::setInstance(LV2_Handle handle, const LV2_Worker_Interface* iface)
+{
+	m_handle = handle;
+	m_iface = iface;
+}
+
+
+
+
+void Lv2Worker::emitResponses()
+{
+	while (m_responseReader.read_space() > 0)
+	{
+		const uint32_t size = readMessage(m_responseReader, m_responseBuf);
+		m_iface->work_response(m_handle, size, m_responseBuf.data());
+	}
+}
+
+
+
+
+void Lv2Worker::notifyEndOfRun()
+{
+	if (m_iface && m_iface->end_run) { m_iface->end_run(m_handle); }
+}
+
+
+
+
+LV2_Worker_Status Lv2Worker::staticScheduleWork(
+	LV2_Worker_Schedule_Handle handle, uint32_t size, const void* data)
+{
+	return static_cast<Lv2Worker*>(handle)->scheduleWork(size, data);
+}
+
+
+
+
+LV2_Worker_Status Lv2Worker::staticRespond(
+	LV2_Worker_Respond_Handle handle, uint32_t size, const void* data)
+{
+	Lv2Worker* worker = static_cast<Lv2Worker*>(handle);
+	return writeMessage(worker->m_responses, worker->m_responseScratch, size, data)
+		? LV2_WORKER_SUCCESS
+		: LV2_WORKER_ERR_NO_SPACE;
+}
+
+
+
+
+LV2_Worker_Status Lv2Worker::scheduleWork(uint32_t size, const void* data)
+{
+	if (!m_iface) { return LV2_WORKER_ERR_UNKNOWN; }
+
+	if (Engine::getSong()->isExporting() && !m_scheduled)
+	{
+		// while rendering, waiting is better than getting the result late
+		m_iface->work(m_handle, staticRespond, this, size, data);
+		return LV2_WORKER_SUCCESS;
+	}
+
+	if (!writeMessage(m_requests, m_requestScratch, size, data))
+	{
+		return LV2_WORKER_ERR_NO_SPACE;
+	}
+	Lv2WorkerPool::inst().schedule(this);
+	return LV2_WORKER_SUCCESS;
+}
+
+
+
+
+void Lv2Worker::work()
+{
+	while (m_requestReader.read_space() > 0)
+	{
+		const uint32_t size = readMessage(m_requestReader, m_requestBuf);
+		m_iface->work(m_handle, staticRespond, this, size, m_requestBuf.data());
+	}
+}
+
+
+
+
+bool Lv2Worker::writeMessage(ringbuffer_t<char>& ring, std::vector<char>& scratch,
+	uint32_t size, const void* data)
+{
+	const std::size_t total = sizeof(size) + size;
+	if (total > scratch.size() || ring.write_space() < total) { return false; }
+
+	// write all at once, so the reader never sees half a message
+	std::memcpy(scratch.data(), &size, sizeof(size));
+	std::memcpy(scratch.data() + sizeof(size), data, size);
+	ring.write(scratch.data(), total);
+	return true;
+}
+
+
+
+
+uint32_t Lv2Worker::readMessage(ringbuffer_reader_t<char>& reader,
+	std::vector<char>& buf)
+{
+	uint32_t size;
+	{
+		auto seq = reader.read(sizeof(size));
+		char* dest = reinterpret_cast<char*>(&size);
+		for (std::size_t i = 0; i < sizeof(size); ++i) { dest[i] = seq[i]; }
+	}
+	{
+		auto seq = reader.read(size);
+		for (uint32_t i = 0; i < size; ++i) { buf[i] = seq[i]; }
+	}
+	return size;
+}
+
+
+} // namespace lmms
+
+#endif // LMMS_HAVE_LV2
@@ -32,6 +32,7 @@
 #include <QDebug>
 #include <QFileInfo>
 #include <QLocale>
+#include <QThread>
 #include <QTimer>
 #include <QTranslator>
 #include <QApplication>
@@ -69,6 +70,7 @@
 #include "MixHelpers.h"
 #include "OutputSettings.h"
 #include "ProjectRenderer.h"
+#include "RenderFarm.h"
 #include "RenderManager.h"
 #include "Song.h"
 
@@ -165,6 +167,10 @@ void printHelp()
 		"  compress <in>                         Compress file <in>\n"
 		"  render <project> [options...]         Render given project file\n"
 		"  rendertracks <project> [options...]   Render each track to a different file\n"
+		"  renderfarm <manifest> [options...]    Render the projects listed in <manifest>\n"
+		"                                        in parallel. Each line of it holds a\n"
+		"                                        project, optionally followed by a tab\n"
+		"                                        and the output file\n"
 		"  upgrade <in> [out]                    Upgrade file <in> and save as <out>\n"
 		"                                        Standard out is used if no output file\n"
 		"                                        is specified\n"
@@ -195,6 +201,9 @@ void printHelp()
 		"            - sincfastest (default)\n"
 		"            - sincmedium\n"
 		"            - sincbest\n"
+		"  -j, --jobs <n>                 Render up to <n> files at once, each in\n"
+		"          its own process. Only for \"rendertracks\" and \"renderfarm\"\n"
+		"          Default: 1 for \"rendertracks\", number of CPUs for \"renderfarm\"\n"
 		"  -l, --loop                     Render as a loop\n"
 		"  -m, --mode                     Stereo mode used for MP3 export\n"
 		"          Possible values: s, j, m\n"
@@ -207,9 +216,13 @@ void printHelp()
 		"          For \"rendertracks\", provide a directory path\n"
 		"          If not specified, render will overwrite the input file\n"
 		"          For \"rendertracks\", this might be required\n"
+		"          For \"renderfarm\", provide the directory for projects\n"
+		"          without an output file in the manifest\n"
 		"  -p, --profile <out>            Dump profiling information to file <out>\n"
 		"  -s, --samplerate <samplerate>  Specify output samplerate in Hz\n"
 		"          Range: 44100 (default) to 192000\n"
+		"      --stem <n>                 With \"rendertracks\", only render the\n"
+		"          track with the (0-based) index <n>\n"
 		"  -x, --oversampling <value>     Specify oversampling\n"
 		"          Possible values: 1, 2, 4, 8\n"
 		"          Default: 2\n\n",
@@ -308,7 +321,16 @@ int main( int argc, char * * argv )
 	bool allowRoot = false;
 	bool renderLoop = false;
 	bool renderTracks = false;
-	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, configFile;
+	int renderJobs = 0;
+	int renderStem = -1;
+	QString fileToLoad, fileToImport, renderOut, renderManifest, profilerOutputFile, configFile;
+
+	// options which are passed on to the processes of a render farm
+	const QStringList forwardedOptions = {
+		"--allowroot", "--config", "-c", "--loop", "-l", "--format", "-f",
+		"--samplerate", "-s", "--bitrate", "-b", "--mode", "-m", "--float", "-a",
+		"--interpolation", "-i", "--oversampling", "-x" };
+	QStringList renderArgs;
 
 	// first of two command-line parsing stages
 	for( int i = 1; i < argc; ++i )
@@ -326,6 +348,10 @@ int main( int argc, char * * argv )
 			coreOnly = true;
 			renderTracks = true;
 		}
+		else if( arg == "renderfarm" )
+		{
+			coreOnly = true;
+		}
 		else if( arg == "--allowroot" )
 		{
 			allowRoot = true;
@@ -370,6 +396,7 @@ int main( int argc, char * * argv )
 	// second of two command-line parsing stages
 	for( int i = 1; i < argc; ++i )
 	{
+		const int optionStart = i;
 		QString arg = argv[i];
 
 		if( arg == "--version" || arg == "-v" )
@@ -487,6 +514,48 @@ int main( int argc, char * * argv )
 			fileToLoad = QString::fromLocal8Bit( argv[i] );
 			renderOut = fileToLoad;
 		}
+		else if( arg == "renderfarm" )
+		{
+			++i;
+
+			if( i == argc )
+			{
+				return usageError( "No manifest specified" );
+			}
+
+
+			renderManifest = QString::fromLocal8Bit( argv[i] );
+		}
+		else if( arg == "--jobs" || arg == "-j" )
+		{
+			++i;
+
+			if( i == argc )
+			{
+				return usageError( "No number of jobs specified" );
+			}
+
+
+			renderJobs = QString( argv[i] ).toInt();
+			if( renderJobs < 1 )
+			{
+				return usageError( QString( "Invalid number of jobs %1" ).arg( argv[i] ) );
+			}
+		}
+		else if( arg == "--stem" )
+		{
+			++i;
+
+			bool ok = false;
+			if( i < argc )
+			{
+				renderStem = QString( argv[i] ).toInt( &ok );
+			}
+			if( !ok || renderStem < 0 )
+			{
+				return usageError( "No valid track index specified" );
+			}
+		}
 		else if( arg == "--loop" || arg == "-l" )
 		{
 			renderLoop = true;
@@ -727,10 +796,27 @@ int main( int argc, char * * argv )
 			}
 			fileToLoad = QString::fromLocal8Bit( argv[i] );
 		}
+
+		if( forwardedOptions.contains( arg ) )
+		{
+			for( int j = optionStart; j <= i; ++j )
+			{
+				renderArgs << QString::fromLocal8Bit( argv[j] );
+			}
+		}
+	}
+
+	if( renderStem >= 0 && !renderTracks )
+	{
+		return usageError( "Option --stem requires \"rendertracks\"" );
 	}
 
 	// Test file argument before continuing
-	if( !fileToLoad.isEmpty() )
+	if( !renderManifest.isEmpty() )
+	{
+		fileCheck( renderManifest );
+	}
+	else if( !fileToLoad.isEmpty() )
 	{
 		fileCheck( fileToLoad );
 	}
@@ -802,9 +888,29 @@ int main( int argc, char * * argv )
 
 	bool destroyEngine = false;
 
+	if( !renderManifest.isEmpty() )
+	{
+		// each project is rendered by a child process, so there is no need
+		// for an engine in this one
+		const QVector<RenderFarm::Job> jobs = RenderFarm::jobsFromManifest( renderManifest,
+				renderOut, ProjectRenderer::getFileExtensionFromFormat( eff ), renderArgs );
+		if( jobs.isEmpty() )
+		{
+			printf( "No projects to render in %s, aborting!\n",
+					renderManifest.toUtf8().constData() );
+			exit( EXIT_FAILURE );
+		}
+
+		RenderFarm * farm = new RenderFarm( jobs,
+				renderJobs > 0 ? renderJobs : QThread::idealThreadCount(), app );
+		QObject::connect( farm, &RenderFarm::finished, [farm]() {
+			QCoreApplication::exit( farm->failedJobs() > 0 ? EXIT_FAILURE : EXIT_SUCCESS );
+		} );
+		farm->start();
+	}
 	// if we have an output file for rendering, just render the song
 	// without starting the GUI
-	if( !renderOut.isEmpty() )
+	else if( !renderOut.isEmpty() )
 	{
 		Engine::init( true );
 		destroyEngine = true;
@@ -833,25 +939,54 @@ int main( int argc, char * * argv )
 		QCoreApplication::instance()->connect( r,
 				SIGNAL(finished()), SLOT(quit()));
 
-		// timer for progress-updates
-		QTimer * t = new QTimer( r );
-		r->connect( t, SIGNAL(timeout()),
-				SLOT(updateConsoleProgress()));
-		t->start( 200 );
-
-		if( profilerOutputFile.isEmpty() == false )
+		if( renderStem >= r->trackPaths().size() )
 		{
-			Engine::audioEngine()->profiler().setOutputFile( profilerOutputFile );
+			printf( "The project %s has no track %d to render, aborting!\n",
+					fileToLoad.toUtf8().constData(), renderStem );
+			exit( EXIT_FAILURE );
 		}
 
-		// start now!
-		if ( renderTracks )
+		if( renderTracks && renderStem < 0 && renderJobs > 1 )
 		{
-			r->renderTracks();
+			// hand each track to a process of its own, which loads the
+			// project again and only renders that one
+			const QStringList paths = r->trackPaths();
+			QVector<RenderFarm::Job> jobs;
+			for( int k = 0; k < paths.size(); ++k )
+			{
+				jobs.push_back( { QStringList{ "rendertracks", fileToLoad,
+						"--output", renderOut, "--stem", QString::number( k ) }
+						+ renderArgs, paths[k] } );
+			}
+
+			RenderFarm * farm = new RenderFarm( jobs, renderJobs, r );
+			QObject::connect( farm, &RenderFarm::finished, [farm]() {
+				QCoreApplication::exit( farm->failedJobs() > 0 ? EXIT_FAILURE : EXIT_SUCCESS );
+			} );
+			farm->start();
 		}
 		else
 		{
-			r->renderProject();
+			// timer for progress-updates
+			QTimer * t = new QTimer( r );
+			r->connect( t, SIGNAL(timeout()),
+					SLOT(updateConsoleProgress()));
+			t->start( 200 );
+
+			if( profilerOutputFile.isEmpty() == false )
+			{
+				Engine::audioEngine()->profiler().setOutputFile( profilerOutputFile );
+			}
+
+			// start now!
+			if ( renderTracks )
+			{
+				r->renderTracks( renderStem );
+			}
+			else
+			{
+				r->renderProject();
+			}
 		}
 	}
 	else // otherwise, start the GUI
@@ -86,15 +86,30 @@ Lv2ViewProc::Lv2ViewProc(QWidget* parent, Lv2Proc* ctrlBase, int colNum) :
 						break;
 				}
 				m_control->setText(port.name());
+				setToolTip(port);
+			}
+		}
+		void visit(const Lv2Ports::Cv& port) override
+		{
+			if (port.m_flow == Lv2Ports::Flow::Input)
+			{
+				// CV ports always get a FloatModel
+				m_control = new KnobControl(m_par);
+				m_control->setText(port.name());
+				setToolTip(port);
+			}
+		}
 
-				AutoLilvNodes props(lilv_port_get_value(
-					port.m_plugin, port.m_port, m_commentUri));
-				LILV_FOREACH(nodes, itr, props.get())
-				{
-					const LilvNode* nod = lilv_nodes_get(props.get(), itr);
-					m_control->topWidget()->setToolTip(lilv_node_as_string(nod));
-					break;
-				}
+	private:
+		void setToolTip(const Lv2Ports::PortBase& port)
+		{
+			AutoLilvNodes props(lilv_port_get_value(
+				port.m_plugin, port.m_port, m_commentUri));
+			LILV_FOREACH(nodes, itr, props.get())
+			{
+				const LilvNode* nod = lilv_nodes_get(props.get(), itr);
+				m_control->topWidget()->setToolTip(lilv_node_as_string(nod));
+				break;
 			}
 		}
 	};
@@ -138,6 +138,8 @@ SetupDialog::SetupDialog(ConfigTabs tab_to_open) :
 			"ui", "vstalwaysontop").toInt()),
 	m_disableAutoQuit(ConfigManager::inst()->value(
 			"ui", "disableautoquit", "1").toInt()),
+	m_pipelinedRemotePlugins(ConfigManager::inst()->value(
+			"audioengine", "pipelinedremoteplugins").toInt()),
 	m_NaNHandler(ConfigManager::inst()->value(
 			"app", "nanhandler", "1").toInt()),
 	m_hqAudioDev(ConfigManager::inst()->value(
@@ -433,6 +435,8 @@ SetupDialog::SetupDialog(ConfigTabs tab_to_open) :
 
 	addLedCheckBox(tr("Keep effects running even without input"), plugins_tw, counter,
 		m_disableAutoQuit, SLOT(toggleDisableAutoQuit(bool)), false);
+	addLedCheckBox(tr("Run VST and ZynAddSubFX plugins one period ahead"), plugins_tw, counter,
+		m_pipelinedRemotePlugins, SLOT(togglePipelinedRemotePlugins(bool)), true);
 
 	plugins_tw->setFixedHeight(YDelta + YDelta * counter);
 
@@ -945,6 +949,8 @@ void SetupDialog::accept()
 					QString::number(m_vstAlwaysOnTop));
 	ConfigManager::inst()->setValue("ui", "disableautoquit",
 					QString::number(m_disableAutoQuit));
+	ConfigManager::inst()->setValue("audioengine", "pipelinedremoteplugins",
+					QString::number(m_pipelinedRemotePlugins));
 	ConfigManager::inst()->setValue("audioengine", "audiodev",
 					m_audioIfaceNames[m_audioInterfaces->currentText()]);
 	ConfigManager::inst()->setValue("app", "nanhandler",
@@ -1142,6 +1148,12 @@ void SetupDialog::toggleDisableAutoQuit(bool enabled)
 }
 
 
+void SetupDialog::togglePipelinedRemotePlugins(bool enabled)
+{
+	m_pipelinedRemotePlugins = enabled;
+}
+
+
 
 
 // Audio settings slots.
@@ -742,23 +742,10 @@ bool InstrumentTrack::play( const TimePos & _start, const fpp_t _frames,
 			cur_start -= c->startPosition();
 		}
 
-		// get all notes from the given clip...
+		// get all notes from the given clip, starting with the first one
+		// which isn't before the current tick
 		const NoteVector & notes = c->notes();
-		// ...and set our index to zero
-		NoteVector::ConstIterator nit = notes.begin();
-
-		// very effective algorithm for playing notes that are
-		// posated within the current sample-frame
-
-
-		if( cur_start > 0 )
-		{
-			// skip notes which are posated before start-bar
-			while( nit != notes.end() && ( *nit )->pos() < cur_start )
-			{
-				++nit;
-			}
-		}
+		NoteVector::ConstIterator nit = notes.begin() + c->firstNoteFrom( cur_start );
 
 		Note * cur_note;
 		while( nit != notes.end() &&
@@ -936,6 +923,7 @@ void InstrumentTrack::loadTrackSpecificSettings( const QDomElement & thisElement
 					m_instrument = Instrument::instantiate(
 						node.toElement().attribute("name"), this, &key);
 					m_instrument->restoreState(node.firstChildElement());
+					m_audioPort.setSourceLatency(m_instrument->latency());
 					emit instrumentChanged();
 				}
 			}
@@ -961,6 +949,7 @@ void InstrumentTrack::loadTrackSpecificSettings( const QDomElement & thisElement
 				{
 					m_instrument->restoreState(node.toElement());
 				}
+				m_audioPort.setSourceLatency(m_instrument->latency());
 				emit instrumentChanged();
 			}
 		}
@@ -1037,6 +1026,7 @@ Instrument * InstrumentTrack::loadInstrument(const QString & _plugin_name,
 	m_instrument = Instrument::instantiate(_plugin_name, this,
 					key, keyFromDnd);
 	unlock();
+	m_audioPort.setSourceLatency(m_instrument->latency());
 	setName(m_instrument->displayName());
 
 	emit instrumentChanged();
@@ -49,7 +49,8 @@ MidiClip::MidiClip( InstrumentTrack * _instrument_track ) :
 	Clip( _instrument_track ),
 	m_instrumentTrack( _instrument_track ),
 	m_clipType( BeatClip ),
-	m_steps( TimePos::stepsPerBar() )
+	m_steps( TimePos::stepsPerBar() ),
+	m_playCursor( 0 )
 {
 	if (_instrument_track->trackContainer()	== Engine::patternStore())
 	{
@@ -66,7 +67,8 @@ MidiClip::MidiClip( const MidiClip& other ) :
 	Clip( other.m_instrumentTrack ),
 	m_instrumentTrack( other.m_instrumentTrack ),
 	m_clipType( other.m_clipType ),
-	m_steps( other.m_steps )
+	m_steps( other.m_steps ),
+	m_playCursor( 0 )
 {
 	for( NoteVector::ConstIterator it = other.m_notes.begin(); it != other.m_notes.end(); ++it )
 	{
@@ -261,6 +263,31 @@ Note * MidiClip::noteAtStep( int _step )
 
 
 
+int MidiClip::firstNoteFrom( const TimePos & pos ) const
+{
+	const auto before = []( const Note * note, const TimePos & p ) { return note->pos() < p; };
+	const int size = m_notes.size();
+
+	// while playing, the notes starting at pos come right after the ones
+	// of the previous ticks, so the last result usually is still right.
+	// After seeking, looping or editing notes it's searched for again.
+	int i = qMin( m_playCursor, size );
+	if( i > 0 && m_notes[i - 1]->pos() >= pos )
+	{
+		i = std::lower_bound( m_notes.begin(), m_notes.begin() + i, pos, before ) - m_notes.begin();
+	}
+	else if( i < size && m_notes[i]->pos() < pos )
+	{
+		i = std::lower_bound( m_notes.begin() + i, m_notes.end(), pos, before ) - m_notes.begin();
+	}
+
+	m_playCursor = i;
+	return i;
+}
+
+
+
+
 void MidiClip::rearrangeAllNotes()
 {
 	// sort notes by start time
@@ -50,7 +50,8 @@ SampleTrack::SampleTrack(TrackContainer* tc) :
 	m_panningModel(DefaultPanning, PanningLeft, PanningRight, 0.1f, this, tr("Panning")),
 	m_mixerChannelModel(0, 0, 0, this, tr("Mixer channel")),
 	m_audioPort(tr("Sample track"), true, &m_volumeModel, &m_panningModel, &m_mutedModel),
-	m_isPlaying(false)
+	m_isPlaying(false),
+	m_playingClipsChanged(false)
 {
 	setName(tr("Sample track"));
 	m_panningModel.setCenterValue(DefaultPanning);
@@ -98,13 +99,42 @@ bool SampleTrack::play( const TimePos & _start, const fpp_t _frames,
 	}
 	else
 	{
-		bool nowPlaying = false;
-		for( int i = 0; i < numOfClips(); ++i )
+		if( m_playingClipsChanged.exchange( false ) )
 		{
-			Clip * clip = getClip( i );
-			SampleClip * sClip = dynamic_cast<SampleClip*>( clip );
+			// setPlayingClips() marked the clips
+			m_playingClips.clear();
+			for( Clip * clip : getClips() )
+			{
+				SampleClip * sClip = static_cast<SampleClip *>( clip );
+				if( sClip->isPlaying() )
+				{
+					m_playingClips.push_back( sClip );
+				}
+			}
+		}
 
+		// clips which were playing but don't contain _start anymore stop
+		for( auto it = m_playingClips.begin(); it != m_playingClips.end(); )
+		{
+			SampleClip * sClip = *it;
 			if( _start >= sClip->startPosition() && _start < sClip->endPosition() )
+			{
+				++it;
+			}
+			else
+			{
+				sClip->setIsPlaying( false );
+				it = m_playingClips.erase( it );
+			}
+		}
+
+		clipVector current;
+		getClipsInRange( current, _start, _start );
+		for( Clip * clip : current )
+		{
+			SampleClip * sClip = dynamic_cast<SampleClip*>( clip );
+
+			if( _start < sClip->endPosition() )
 			{
 				if( sClip->isPlaying() == false && _start >= (sClip->startPosition() + sClip->startTimeOffset()) )
 				{
@@ -122,17 +152,12 @@ bool SampleTrack::play( const TimePos & _start, const fpp_t _frames,
 						sClip->setSamplePlayLength( samplePlayLength );
 						clips.push_back( sClip );
 						sClip->setIsPlaying( true );
-						nowPlaying = true;
+						m_playingClips.push_back( sClip );
 					}
 				}
 			}
-			else
-			{
-				sClip->setIsPlaying( false );
-			}
-			nowPlaying = nowPlaying || sClip->isPlaying();
 		}
-		setPlaying(nowPlaying);
+		setPlaying( !m_playingClips.empty() );
 	}
 
 	for( clipVector::Iterator it = clips.begin(); it != clips.end(); ++it )
@@ -244,6 +269,8 @@ void SampleTrack::setPlayingClips( bool isPlaying )
 		SampleClip * sClip = dynamic_cast<SampleClip*>( clip );
 		sClip->setIsPlaying( isPlaying );
 	}
+	// this usually runs on the GUI thread, so let play() update its list
+	m_playingClipsChanged = true;
 }
 
 
@@ -0,0 +1,149 @@
+/*
+ * MixHelpersBenchmark.cpp - compare the MixHelpers instruction sets
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+// Usage: mixhelpers_benchmark [frames per period]
+// Prints the time per frame of each primitive for every instruction set the
+// machine supports, and the speedup against the scalar code.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "denormals.h"
+#include "MixHelpers.h"
+#include "ValueBuffer.h"
+
+using namespace lmms;
+
+namespace
+{
+
+constexpr int Periods = 20000;
+
+double nsPerFrame( const std::function<void()>& op, int frames )
+{
+	// warm up caches and clocks
+	for( int i = 0; i < Periods / 10; ++i ) { op(); }
+
+	const auto start = std::chrono::steady_clock::now();
+	for( int i = 0; i < Periods; ++i ) { op(); }
+	const auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>( end - start ).count()
+		/ ( static_cast<double>( Periods ) * frames );
+}
+
+}
+
+
+
+
+int main( int argc, char* argv[] )
+{
+	const int frames = argc > 1 ? std::atoi( argv[1] ) : 256;
+	if( frames <= 0 )
+	{
+		std::fprintf( stderr, "invalid number of frames\n" );
+		return 1;
+	}
+
+	std::mt19937 rng( 42 );
+	std::uniform_real_distribution<float> dist( -1.0f, 1.0f );
+	std::vector<sampleFrame> src( frames );
+	std::vector<sampleFrame> dst( frames );
+	ValueBuffer coeffs( frames );
+	ValueBuffer panning( frames );
+	for( int f = 0; f < frames; ++f )
+	{
+		src[f] = { dist( rng ), dist( rng ) };
+		dst[f] = { dist( rng ), dist( rng ) };
+		// the results are fed back into the buffers, so use gains which
+		// neither decay into denormals nor blow up
+		coeffs[f] = dist( rng ) < 0 ? -1.0f : 1.0f;
+		panning[f] = 0.0f;
+	}
+	MixHelpers::setNaNHandler( true );
+	disable_denormals();
+
+	struct Case
+	{
+		const char* name;
+		std::function<void()> op;
+	} ;
+	const std::vector<Case> cases = {
+		{ "add", [&] { MixHelpers::add( dst.data(), src.data(), frames ); } },
+		{ "addMultiplied", [&] { MixHelpers::addMultiplied( dst.data(), src.data(), -1.0f, frames ); } },
+		{ "addSanitizedMultiplied", [&] { MixHelpers::addSanitizedMultiplied( dst.data(), src.data(), 1.0f, frames ); } },
+		{ "addSanitizedMultipliedByBuffers", [&] {
+			MixHelpers::addSanitizedMultipliedByBuffers( dst.data(), src.data(), &coeffs, &coeffs, frames ); } },
+		{ "sanitize", [&] { MixHelpers::sanitize( dst.data(), frames ); } },
+		{ "isSilent", [&] { MixHelpers::isSilent( dst.data(), frames ); } },
+		{ "peak", [&] { float l = 0, r = 0; MixHelpers::peak( src.data(), frames, l, r ); } },
+		{ "multiply", [&] { MixHelpers::multiply( dst.data(), 1.0f, -1.0f, frames ); } },
+		{ "multiplyByBuffer", [&] { MixHelpers::multiplyByBuffer( dst.data(), &coeffs, 1.0f, -1.0f, frames ); } },
+		{ "multiplyByPanningBuffer", [&] {
+			MixHelpers::multiplyByPanningBuffer( dst.data(), &coeffs, 1.0f, &panning, 0.01f, frames ); } },
+	};
+
+	const MixHelpers::Isa isas[] = { MixHelpers::Isa::Scalar, MixHelpers::Isa::Sse2,
+						MixHelpers::Isa::Avx2, MixHelpers::Isa::Avx512 };
+
+	std::printf( "%d frames per period, ns/frame (speedup against scalar)\n", frames );
+	std::printf( "%-34s", "" );
+	for( MixHelpers::Isa isa : isas )
+	{
+		std::printf( "%18s", MixHelpers::isaName( isa ) );
+	}
+	std::printf( "\n" );
+
+	for( const Case& c : cases )
+	{
+		std::printf( "%-34s", c.name );
+		double scalar = 0;
+		for( MixHelpers::Isa isa : isas )
+		{
+			if( ! MixHelpers::setIsa( isa ) )
+			{
+				std::printf( "%18s", "-" );
+				continue;
+			}
+			const double ns = nsPerFrame( c.op, frames );
+			if( isa == MixHelpers::Isa::Scalar )
+			{
+				scalar = ns;
+				std::printf( "%18.3f", ns );
+			}
+			else
+			{
+				std::printf( "%10.3f (%4.1fx)", ns, scalar / ns );
+			}
+		}
+		std::printf( "\n" );
+	}
+
+	return 0;
+}
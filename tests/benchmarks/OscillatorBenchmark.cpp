@@ -0,0 +1,148 @@
+/*
+ * OscillatorBenchmark.cpp - how many TripleOscillator-like voices a core renders
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+// Usage: oscillator_benchmark [frames per period]
+// A voice consists of three chained oscillators per channel, like a note of
+// TripleOscillator. Prints how many of these voices one core can render in
+// realtime for every wave shape and modulation algorithm. Build it at two
+// commits to compare the oscillator kernels before and after a change.
+
+#include <QCoreApplication>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "AudioEngine.h"
+#include "AutomatableModel.h"
+#include "denormals.h"
+#include "Engine.h"
+#include "Oscillator.h"
+
+using namespace lmms;
+
+namespace
+{
+
+constexpr int Periods = 2000;
+
+struct Voice
+{
+	Voice( int shape, int algo ) :
+		shapeModel( shape, 0, Oscillator::NumWaveShapes - 1 ),
+		algoModel( algo, 0, Oscillator::NumModulationAlgos - 1 )
+	{
+		const float sampleRate = Engine::audioEngine()->processingSampleRate();
+		for( int i = 0; i < 3; ++i )
+		{
+			freqs[i] = 220.0f * ( i + 1 );
+			detunings[i] = 1.0f / sampleRate;
+			phaseOffsets[i] = 0.0f;
+			volumes[i] = 0.3f;
+		}
+		for( int chnl = 0; chnl < 2; ++chnl )
+		{
+			Oscillator * sub = nullptr;
+			for( int i = 2; i >= 0; --i )
+			{
+				sub = new Oscillator( &shapeModel, &algoModel, freqs[i], detunings[i],
+							phaseOffsets[i], volumes[i], sub );
+				sub->setUseWaveTable( true );
+			}
+			oscillators[chnl].reset( sub );
+		}
+	}
+
+	void render( sampleFrame * buffer, fpp_t frames )
+	{
+		oscillators[0]->update( buffer, frames, 0 );
+		oscillators[1]->update( buffer, frames, 1 );
+	}
+
+	IntModel shapeModel;
+	IntModel algoModel;
+	float freqs[3];
+	float detunings[3];
+	float phaseOffsets[3];
+	float volumes[3];
+	std::unique_ptr<Oscillator> oscillators[2];
+} ;
+
+}
+
+
+
+
+int main( int argc, char* argv[] )
+{
+	const int frames = argc > 1 ? std::atoi( argv[1] ) : 256;
+	if( frames <= 0 )
+	{
+		std::fprintf( stderr, "invalid number of frames\n" );
+		return 1;
+	}
+
+	new QCoreApplication( argc, argv );
+	Engine::init( true );
+	disable_denormals();
+
+	const double periodSeconds = static_cast<double>( frames ) /
+					Engine::audioEngine()->processingSampleRate();
+	std::vector<sampleFrame> buffer( frames );
+
+	const char * shapes[] = { "sine", "triangle", "saw", "square", "moog saw", "exponential", "noise" };
+	const char * algos[] = { "PM", "AM", "mix", "sync", "FM" };
+
+	std::printf( "%d frames per period, voices per core\n", frames );
+	std::printf( "%-12s", "" );
+	for( const char * algo : algos )
+	{
+		std::printf( "%10s", algo );
+	}
+	std::printf( "\n" );
+
+	for( int shape = 0; shape < static_cast<int>( sizeof( shapes ) / sizeof( shapes[0] ) ); ++shape )
+	{
+		std::printf( "%-12s", shapes[shape] );
+		for( int algo = 0; algo < Oscillator::NumModulationAlgos; ++algo )
+		{
+			Voice voice( shape, algo );
+			// warm up caches and clocks
+			for( int i = 0; i < Periods / 10; ++i ) { voice.render( buffer.data(), frames ); }
+
+			const auto start = std::chrono::steady_clock::now();
+			for( int i = 0; i < Periods; ++i ) { voice.render( buffer.data(), frames ); }
+			const auto end = std::chrono::steady_clock::now();
+
+			const double seconds = std::chrono::duration<double>( end - start ).count() / Periods;
+			std::printf( "%10.0f", periodSeconds / seconds );
+		}
+		std::printf( "\n" );
+	}
+
+	Engine::destroy();
+	return 0;
+}
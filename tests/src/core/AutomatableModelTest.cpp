@@ -25,6 +25,7 @@
 #include "QTestSuite.h"
 
 #include "AutomatableModel.h"
+#include "AutomationCurve.h"
 #include "ComboBoxModel.h"
 
 class AutomatableModelTest : QTestSuite
@@ -100,6 +101,45 @@ private slots: // tests
 		QVERIFY(m2.value());
 		QVERIFY(!m3.value());
 	}
+
+	//! Test that automation curves are followed from the frame they are set at
+	void AutomationCurveTests()
+	{
+		using namespace lmms;
+
+		// rises from 0 to 1 within 100 ticks
+		AutomationCurve::Segment segment;
+		segment.start = 0;
+		segment.end = 100;
+		segment.inValue = 0;
+		segment.a0 = 0;
+		segment.a1 = 1;
+		segment.a2 = segment.a3 = 0;
+		segment.invLength = 0.01f;
+		const AutomationCurve ramp({segment}, 100, 1, 1);
+		const AutomationCurve one({}, 0, 1, 1);
+
+		FloatModel model(0, 0, 1);
+		model.setAutomatedValue(0.5f);
+		model.setAutomationCurve(&ramp, 50, 100, 0, 0.1f);
+		// this only continues the ramp
+		model.setAutomationCurve(&ramp, 52, 100, 20, 0.1f);
+		// playback jumps back
+		model.setAutomationCurve(&ramp, 0, 100, 40, 0.1f);
+		// and another clip takes over
+		model.setAutomationCurve(&one, 0, 100, 60, 0.1f);
+
+		const ValueBuffer* vb = model.valueBuffer();
+		QVERIFY(vb != nullptr);
+		const float* values = vb->values();
+		QVERIFY(qAbs(values[0] - 0.5f) < 1e-5f);
+		QVERIFY(qAbs(values[30] - 0.53f) < 1e-5f);
+		QVERIFY(qAbs(values[39] - 0.539f) < 1e-5f);
+		QCOMPARE(values[40], 0.f);
+		QVERIFY(qAbs(values[59] - 0.019f) < 1e-5f);
+		QCOMPARE(values[60], 1.f);
+		QCOMPARE(values[vb->length() - 1], 1.f);
+	}
 } AutomatableModelTests;
 
 #include "AutomatableModelTest.moc"
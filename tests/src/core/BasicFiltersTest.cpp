@@ -0,0 +1,157 @@
+/*
+ * BasicFiltersTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include <cmath>
+
+#include "BasicFilters.h"
+
+class BasicFiltersTest : QTestSuite
+{
+	Q_OBJECT
+private:
+	static constexpr int Frames = 256;
+
+	static void fillInput(lmms::sampleFrame* buf)
+	{
+		// two saws, so the output doesn't depend on the math library
+		for (int frame = 0; frame < Frames; ++frame)
+		{
+			buf[frame][0] = ((frame * 7) % 64) / 32.0f - 1.0f;
+			buf[frame][1] = ((frame * 11) % 50) / 25.0f - 1.0f;
+		}
+	}
+
+	static void sweepCutoff(lmms::BasicFilters<>& filter, int frame)
+	{
+		if (frame % 16 == 0)
+		{
+			filter.calcFilterCoeffs(200.0f + frame * 30.0f, 0.7f);
+		}
+	}
+
+	static bool closeTo(float value, float expected)
+	{
+		// the coefficients come from sinf(), powf() etc., which may round
+		// differently on other platforms
+		return std::abs(value - expected) <= 1e-3f * (1.0f + std::abs(expected));
+	}
+
+private slots:
+	//! Filters a sweep with every filter type and compares the result to
+	//! what the filters returned before the type was hoisted out of the
+	//! per-sample loop
+	void OutputTests()
+	{
+		using namespace lmms;
+
+		// out[127][0], out[255][1] and the sums of the magnitudes of both
+		// channels, one line per filter type
+		static const float expected[BasicFilters<>::NumFilters][4] = {
+			{ 0.0920370072f, 0.312803835f, 52.8846626f, 26.1511002f },
+			{ 0.0912876129f, -0.955948472f, 92.6574097f, 119.843468f },
+			{ 0.41854766f, -0.109798804f, 55.9957314f, 37.9958496f },
+			{ 0.597925246f, -0.156855404f, 79.9938889f, 54.2797813f },
+			{ 0.183324754f, -0.643144608f, 84.7143707f, 104.959015f },
+			{ -0.414600551f, -0.486289263f, 116.654678f, 124.252045f },
+			{ -0.217045024f, 0.31039682f, 62.578373f, 25.5307446f },
+			{ -0.215999618f, -0.0864062905f, 38.5173645f, 17.358181f },
+			{ 0.490167022f, -0.281937242f, 63.5212784f, 46.8124924f },
+			{ 0.346653104f, -0.310660601f, 39.9374275f, 36.5368462f },
+			{ 0.355683446f, -0.555859327f, 80.2679291f, 97.1609955f },
+			{ 0.170229837f, 0.0573257208f, 41.795269f, 23.1172886f },
+			{ 0.119511217f, -0.120157406f, 15.5110207f, 11.9418783f },
+			{ 0.0119325286f, -0.256696671f, 54.1789169f, 71.6287155f },
+			{ 0.0171469077f, 0.0395241417f, 11.1593695f, 5.42410469f },
+			{ 0.115173683f, -0.168203294f, 65.3750992f, 29.6845398f },
+			{ -0.0832659453f, 0.155192912f, 31.6878242f, 18.3291225f },
+			{ 0.121079795f, -0.140036166f, 17.9360867f, 12.3447866f },
+			{ -0.000697731972f, 0.16969502f, 65.4546967f, 80.4891815f },
+			{ -0.0839636773f, 0.324887931f, 76.5712128f, 83.4156647f },
+			{ 0.0244374666f, 0.0186329652f, 7.91118908f, 3.92978859f },
+			{ -0.0909950137f, 0.146550134f, 35.2356949f, 17.6355419f },
+		};
+
+		for (int type = 0; type < BasicFilters<>::NumFilters; ++type)
+		{
+			BasicFilters<> filter(44100);
+			filter.setFilterType(type);
+
+			sampleFrame buf[Frames];
+			fillInput(buf);
+			float sum[2] = { 0.0f, 0.0f };
+			for (int frame = 0; frame < Frames; ++frame)
+			{
+				sweepCutoff(filter, frame);
+				for (ch_cnt_t chnl = 0; chnl < 2; ++chnl)
+				{
+					buf[frame][chnl] = filter.update(buf[frame][chnl], chnl);
+					sum[chnl] += std::abs(buf[frame][chnl]);
+				}
+			}
+
+			QVERIFY2(closeTo(buf[127][0], expected[type][0]), qPrintable(QString::number(type)));
+			QVERIFY2(closeTo(buf[255][1], expected[type][1]), qPrintable(QString::number(type)));
+			QVERIFY2(closeTo(sum[0], expected[type][2]), qPrintable(QString::number(type)));
+			QVERIFY2(closeTo(sum[1], expected[type][3]), qPrintable(QString::number(type)));
+		}
+	}
+
+	//! process() has to filter the same as calling update() for every sample
+	void ProcessTests()
+	{
+		using namespace lmms;
+
+		for (int type = 0; type < BasicFilters<>::NumFilters; ++type)
+		{
+			BasicFilters<> perSample(44100);
+			perSample.setFilterType(type);
+			sampleFrame expected[Frames];
+			fillInput(expected);
+			for (int frame = 0; frame < Frames; ++frame)
+			{
+				sweepCutoff(perSample, frame);
+				for (ch_cnt_t chnl = 0; chnl < 2; ++chnl)
+				{
+					expected[frame][chnl] = perSample.update(expected[frame][chnl], chnl);
+				}
+			}
+
+			BasicFilters<> perPeriod(44100);
+			perPeriod.setFilterType(type);
+			sampleFrame buf[Frames];
+			fillInput(buf);
+			perPeriod.process(buf, Frames, [&](fpp_t frame) { sweepCutoff(perPeriod, frame); });
+
+			for (int frame = 0; frame < Frames; ++frame)
+			{
+				QVERIFY2(closeTo(buf[frame][0], expected[frame][0]), qPrintable(QString::number(type)));
+				QVERIFY2(closeTo(buf[frame][1], expected[frame][1]), qPrintable(QString::number(type)));
+			}
+		}
+	}
+} BasicFiltersTests;
+
+#include "BasicFiltersTest.moc"
@@ -0,0 +1,106 @@
+/*
+ * ClipIndexTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "AutomationClip.h"
+#include "ClipIndex.h"
+
+class ClipIndexTest : QTestSuite
+{
+	Q_OBJECT
+private:
+	//! What Track::getClipsInRange() does without an index
+	static void scanClips(const QVector<lmms::Clip*>& clips, QVector<lmms::Clip*>& result,
+		lmms::tick_t start, lmms::tick_t end)
+	{
+		using namespace lmms;
+		for (Clip* clip : clips)
+		{
+			if (clip->startPosition() <= end && clip->endPosition() >= start)
+			{
+				result.insert(std::upper_bound(result.begin(), result.end(), clip, Clip::comparePosition),
+					clip);
+			}
+		}
+	}
+
+private slots:
+	void EmptyIndexTests()
+	{
+		using namespace lmms;
+
+		ClipIndex index;
+		QVector<Clip*> result;
+		index.clipsInRange(result, 0, 1000);
+		QVERIFY(result.isEmpty());
+	}
+
+	void RangeQueryTests()
+	{
+		using namespace lmms;
+
+		// overlapping clips of all lengths, some starting at the same time
+		std::vector<std::unique_ptr<AutomationClip>> owned;
+		QVector<Clip*> clips;
+		unsigned int seed = 1;
+		for (int i = 0; i < 100; ++i)
+		{
+			seed = seed * 1103515245 + 12345;
+			auto clip = std::make_unique<AutomationClip>(nullptr);
+			clip->movePosition((seed >> 8) % 50 * 48);
+			clip->changeLength((seed >> 16) % 20 * 48);
+			clips.push_back(clip.get());
+			owned.push_back(std::move(clip));
+		}
+
+		const ClipIndex index(clips);
+		for (tick_t start = 0; start < 2600; start += 37)
+		{
+			for (tick_t length : {0, 1, 48, 500})
+			{
+				QVector<Clip*> expected;
+				scanClips(clips, expected, start, start + length);
+				QVector<Clip*> result;
+				index.clipsInRange(result, start, start + length);
+				QCOMPARE(result, expected);
+			}
+		}
+
+		// results are merged into what was collected before, like the clips
+		// of several tracks are
+		QVector<Clip*> expected;
+		scanClips(clips, expected, 0, 100);
+		QVector<Clip*> result = expected;
+		scanClips(clips, expected, 1000, 1200);
+		index.clipsInRange(result, 1000, 1200);
+		QCOMPARE(result, expected);
+	}
+} ClipIndexTests;
+
+#include "ClipIndexTest.moc"
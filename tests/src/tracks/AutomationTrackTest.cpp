@@ -79,6 +79,42 @@ private slots:
 		QCOMPARE(c.valueAt(150), 1.0f);
 	}
 
+	void testClipCurve()
+	{
+		using namespace lmms;
+
+		const AutomationClip::ProgressionTypes progressions[] = {
+			AutomationClip::DiscreteProgression,
+			AutomationClip::LinearProgression,
+			AutomationClip::CubicHermiteProgression
+		};
+
+		for (const auto progression : progressions)
+		{
+			AutomationClip c(nullptr);
+			c.setProgressionType(progression);
+			c.putValue(10, 0.2, false);
+			c.putValue(40, 0.9, false);
+			c.putValue(90, 0.1, false);
+			c.putValue(100, 0.5, false);
+
+			// the compiled curve has to agree with the nodes at every tick
+			for (int tick = 0; tick <= 120; ++tick)
+			{
+				QVERIFY(qAbs(c.curveValueAt(tick) - c.valueAt(tick)) < 1e-4f);
+			}
+		}
+
+		AutomationClip c(nullptr);
+		c.setProgressionType(AutomationClip::LinearProgression);
+		c.putValue(0, 0.0, false);
+		c.putValue(100, 1.0, false);
+
+		// and it is continuous between them
+		int cursor = 0;
+		QVERIFY(qAbs(c.curve()->valueAt(12.5f, cursor) - 0.125f) < 1e-6f);
+	}
+
 	void testClips()
 	{
 		using namespace lmms;